@@ -0,0 +1,84 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Microbenchmark of the AudioKernels implementations.
+// Usage: bench_audio_kernels [iterations]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "audio_kernels.h"
+
+using namespace AudioKernels;
+
+namespace {
+	// One audio callback of 2048 stereo frames with all 33 channels of GenericAudio
+	constexpr int frames = 2048;
+	constexpr int channels = 33;
+
+	void Run(int iterations, AudioDecoder::Format format) {
+		std::mt19937 rng(42);
+		std::vector<uint8_t> samples(frames * 2 * AudioDecoder::GetSamplesizeForFormat(format));
+		if (format == AudioDecoder::Format::F32) {
+			std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+			for (size_t i = 0; i < samples.size(); i += sizeof(float)) {
+				float v = dist(rng);
+				memcpy(&samples[i], &v, sizeof(v));
+			}
+		} else {
+			for (auto& s : samples) {
+				s = rng();
+			}
+		}
+		std::vector<float> mix(frames * 2);
+		std::vector<int16_t> output(frames * 2);
+
+		for (Implementation impl : { Impl_Scalar, Impl_Vector128 }) {
+			if (!IsSupported(impl)) {
+				continue;
+			}
+
+			auto start = std::chrono::steady_clock::now();
+			for (int i = 0; i < iterations; ++i) {
+				for (int c = 0; c < channels; ++c) {
+					Mix(mix.data(), samples.data(), frames, format, 2, 0.5f, c == 0, impl);
+				}
+				Clip(output.data(), mix.data(), frames * 2, channels * 0.5f, impl);
+			}
+			std::chrono::duration<double, std::micro> us = std::chrono::steady_clock::now() - start;
+
+			printf("Mix %-2d channels %-4s %-7s %9.1f us/callback\n", channels,
+				format == AudioDecoder::Format::S16 ? "S16" : "F32", GetName(impl), us.count() / iterations);
+		}
+	}
+}
+
+int main(int argc, char* argv[]) {
+	int iterations = argc > 1 ? atoi(argv[1]) : 1000;
+	if (iterations <= 0) {
+		fprintf(stderr, "Invalid iteration count\n");
+		return EXIT_FAILURE;
+	}
+
+	Run(iterations, AudioDecoder::Format::S16);
+	Run(iterations, AudioDecoder::Format::F32);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,86 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Microbenchmark of the BitmapKernels implementations.
+// Usage: bench_bitmap_kernels [iterations]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <vector>
+#include "bitmap_kernels.h"
+
+using namespace BitmapKernels;
+
+namespace {
+	// Fullscreen picture at 320x240
+	constexpr int width = 320;
+	constexpr int height = 240;
+
+	void Run(const char* name, int iterations, const std::function<void(uint32_t*, int, Implementation)>& kernel) {
+		std::mt19937 rng(42);
+		std::vector<uint32_t> input(width * height);
+		for (auto& p : input) {
+			p = rng() | 0xFF;
+		}
+
+		for (Implementation impl : { Impl_Scalar, Impl_Vector128, Impl_Vector256 }) {
+			if (!IsSupported(impl)) {
+				continue;
+			}
+
+			std::vector<uint32_t> pixels = input;
+			auto start = std::chrono::steady_clock::now();
+			for (int i = 0; i < iterations; ++i) {
+				for (int y = 0; y < height; ++y) {
+					kernel(pixels.data() + y * width, width, impl);
+				}
+			}
+			std::chrono::duration<double, std::micro> us = std::chrono::steady_clock::now() - start;
+
+			printf("%-22s %-7s %9.1f us/frame %8.1f Mpixel/s\n", name, GetName(impl),
+				us.count() / iterations, (double)width * height * iterations / us.count());
+		}
+	}
+}
+
+int main(int argc, char* argv[]) {
+	int iterations = argc > 1 ? atoi(argv[1]) : 200;
+	if (iterations <= 0) {
+		fprintf(stderr, "Invalid iteration count\n");
+		return EXIT_FAILURE;
+	}
+
+	const Shifts shifts = { 24, 16, 8, 0 };
+
+	Run("ToneRow color", iterations, [&](uint32_t* p, int n, Implementation impl) {
+		ToneRow(p, n, Tone(60, 80, 170, 128), shifts, true, impl);
+	});
+	Run("ToneRow saturation", iterations, [&](uint32_t* p, int n, Implementation impl) {
+		ToneRow(p, n, Tone(128, 128, 128, 40), shifts, true, impl);
+	});
+	Run("ToneRow color+sat", iterations, [&](uint32_t* p, int n, Implementation impl) {
+		ToneRow(p, n, Tone(200, 90, 90, 200), shifts, false, impl);
+	});
+	Run("HueChangeRow", iterations, [&](uint32_t* p, int n, Implementation impl) {
+		HueChangeRow(p, n, 0x240, impl);
+	});
+
+	return EXIT_SUCCESS;
+}
@@ -28,6 +28,15 @@
 #define ICONV_CONST const
 #endif
 
+static bool IsAscii(const std::string& str) {
+	for (unsigned char c : str) {
+		if (c >= 0x80) {
+			return false;
+		}
+	}
+	return true;
+}
+
 static std::string filterUtf8Compatible(std::string enc) {
 #ifdef LCF_SUPPORT_ICU
 	if (ucnv_compareNames(enc.c_str(), "UTF-8") == 0) {
@@ -52,14 +61,14 @@ bool Encoder::IsOk() const {
 }
 
 void Encoder::Encode(std::string& str) {
-	if (_encoding.empty() || str.empty()) {
+	if (_encoding.empty() || str.empty() || (_ascii_compatible && IsAscii(str))) {
 		return;
 	}
 	Convert(str, _conv_runtime, _conv_storage);
 }
 
 void Encoder::Decode(std::string& str) {
-	if (_encoding.empty() || str.empty()) {
+	if (_encoding.empty() || str.empty() || (_ascii_compatible && IsAscii(str))) {
 		return;
 	}
 	Convert(str, _conv_storage, _conv_runtime);
@@ -101,6 +110,18 @@ void Encoder::Init() {
 	_conv_runtime = const_cast<char*>("UTF-8");
 	_conv_storage = const_cast<char*>(_encoding.c_str());
 #endif
+
+	// Most strings are plain ASCII and need no conversion, unless the
+	// encoding replaces ASCII characters like Shift-JIS the backslash
+	std::string ascii;
+	for (int c = 1; c <= 0x7F; ++c) {
+		ascii.push_back(static_cast<char>(c));
+	}
+	std::string encoded = ascii;
+	Encode(encoded);
+	std::string decoded = ascii;
+	Decode(decoded);
+	_ascii_compatible = (encoded == ascii && decoded == ascii);
 }
 
 void Encoder::Reset() {
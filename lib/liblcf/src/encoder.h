@@ -36,6 +36,8 @@ class Encoder {
 		void* _conv_runtime = nullptr;
 		std::vector<char> _buffer;
 		std::string _encoding;
+		/** Whether ASCII characters are the same in both encodings */
+		bool _ascii_compatible = false;
 };
 
 
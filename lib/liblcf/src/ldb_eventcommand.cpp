@@ -47,8 +47,9 @@ void RawStruct<RPG::EventCommand>::ReadLcf(RPG::EventCommand& event_command, Lcf
 void RawStruct<RPG::EventCommand>::WriteLcf(const RPG::EventCommand& event_command, LcfWriter& stream) {
 	stream.Write(event_command.code);
 	stream.Write(event_command.indent);
-	stream.WriteInt(stream.Decode(event_command.string).size());
-	stream.Write(event_command.string);
+	const std::string str = stream.Decode(event_command.string);
+	stream.WriteInt(str.size());
+	stream.Write(str.data(), 1, str.size());
 	int32_t count = (int32_t)event_command.parameters.size();
 	stream.Write(count);
 	for (int i = 0; i < count; i++)
@@ -59,8 +60,9 @@ int RawStruct<RPG::EventCommand>::LcfSize(const RPG::EventCommand& event_command
 	int result = 0;
 	result += LcfReader::IntSize(event_command.code);
 	result += LcfReader::IntSize(event_command.indent);
-	result += LcfReader::IntSize(stream.Decode(event_command.string).size());
-	result += stream.Decode(event_command.string).size();
+	const size_t str_size = stream.Decode(event_command.string).size();
+	result += LcfReader::IntSize(str_size);
+	result += str_size;
 	int count = event_command.parameters.size();
 	result += LcfReader::IntSize(count);
 	for (int i = 0; i < count; i++)
@@ -21,12 +21,43 @@ void LDB_Reader::PrepareSave(RPG::Database& db) {
 	++db.system.save_count;
 }
 
+static bool LoadLcf(LcfReader& reader) {
+	if (!reader.IsOk()) {
+		LcfReader::SetError("Couldn't parse database file.\n");
+		return false;
+	}
+	std::string header;
+	reader.ReadString(header, reader.ReadInt());
+	if (header.length() != 11) {
+		LcfReader::SetError("This is not a valid RPG2000 database.\n");
+		return false;
+	}
+	if (header != "LcfDataBase") {
+		fprintf(stderr, "Warning: This header is not LcfDataBase and might not be a valid RPG2000 database.\n");
+	}
+	Data::data.ldb_header = header;
+	TypeReader<RPG::Database>::ReadLcf(Data::data, reader, 0);
+
+	// Delayed initialization of some actor fields because they are engine
+	// dependent
+	std::vector<RPG::Actor>::iterator it;
+	for (it = Data::actors.begin(); it != Data::actors.end(); ++it) {
+		(*it).Setup();
+	}
+
+	return true;
+}
+
 bool LDB_Reader::Load(const std::string& filename, const std::string& encoding) {
 	std::ifstream stream(filename.c_str(), std::ios::binary);
 	if (!stream.is_open()) {
 		fprintf(stderr, "Failed to open LDB file `%s' for reading : %s\n", filename.c_str(), strerror(errno));
 		return false;
 	}
+	std::vector<char> buffer;
+	if (LcfReader::ReadAll(stream, buffer)) {
+		return LDB_Reader::Load(buffer.data(), buffer.size(), encoding);
+	}
 	return LDB_Reader::Load(stream, encoding);
 }
 
@@ -59,30 +90,12 @@ bool LDB_Reader::LoadXml(const std::string& filename) {
 
 bool LDB_Reader::Load(std::istream& filestream, const std::string& encoding) {
 	LcfReader reader(filestream, encoding);
-	if (!reader.IsOk()) {
-		LcfReader::SetError("Couldn't parse database file.\n");
-		return false;
-	}
-	std::string header;
-	reader.ReadString(header, reader.ReadInt());
-	if (header.length() != 11) {
-		LcfReader::SetError("This is not a valid RPG2000 database.\n");
-		return false;
-	}
-	if (header != "LcfDataBase") {
-		fprintf(stderr, "Warning: This header is not LcfDataBase and might not be a valid RPG2000 database.\n");
-	}
-	Data::data.ldb_header = header;
-	TypeReader<RPG::Database>::ReadLcf(Data::data, reader, 0);
-
-	// Delayed initialization of some actor fields because they are engine
-	// dependent
-	std::vector<RPG::Actor>::iterator it;
-	for (it = Data::actors.begin(); it != Data::actors.end(); ++it) {
-		(*it).Setup();
-	}
+	return LoadLcf(reader);
+}
 
-	return true;
+bool LDB_Reader::Load(const char* data, size_t size, const std::string& encoding) {
+	LcfReader reader(data, size, encoding);
+	return LoadLcf(reader);
 }
 
 bool LDB_Reader::Save(std::ostream& filestream, const std::string& encoding, SaveOpt opt) {
@@ -71,6 +71,11 @@ namespace LDB_Reader {
 	 */
 	bool Load(std::istream& filestream, const std::string& encoding);
 
+	/**
+	 * Loads Database from a buffer holding the whole file.
+	 */
+	bool Load(const char* data, size_t size, const std::string& encoding);
+
 	/**
 	 * Saves Database.
 	 */
@@ -17,12 +17,35 @@
 #include "reader_util.h"
 #include "reader_struct.h"
 
+static bool LoadLcf(LcfReader& reader) {
+	if (!reader.IsOk()) {
+		LcfReader::SetError("Couldn't parse map tree file.\n");
+		return false;
+	}
+	std::string header;
+	reader.ReadString(header, reader.ReadInt());
+	if (header.length() != 10) {
+		LcfReader::SetError("This is not a valid RPG2000 map tree.\n");
+		return false;
+	}
+	if (header != "LcfMapTree") {
+		fprintf(stderr, "Warning: This header is not LcfMapTree and might not be a valid RPG2000 map tree.\n");
+	}
+	Data::treemap.lmt_header = std::move(header);
+	TypeReader<RPG::TreeMap>::ReadLcf(Data::treemap, reader, 0);
+	return true;
+}
+
 bool LMT_Reader::Load(const std::string& filename, const std::string& encoding) {
 	std::ifstream stream(filename.c_str(), std::ios::binary);
 	if (!stream.is_open()) {
 		fprintf(stderr, "Failed to open LMT file `%s' for reading : %s\n", filename.c_str(), strerror(errno));
 		return false;
 	}
+	std::vector<char> buffer;
+	if (LcfReader::ReadAll(stream, buffer)) {
+		return LMT_Reader::Load(buffer.data(), buffer.size(), encoding);
+	}
 	return LMT_Reader::Load(stream, encoding);
 }
 
@@ -55,22 +78,12 @@ bool LMT_Reader::LoadXml(const std::string& filename) {
 
 bool LMT_Reader::Load(std::istream& filestream, const std::string &encoding) {
 	LcfReader reader(filestream, encoding);
-	if (!reader.IsOk()) {
-		LcfReader::SetError("Couldn't parse map tree file.\n");
-		return false;
-	}
-	std::string header;
-	reader.ReadString(header, reader.ReadInt());
-	if (header.length() != 10) {
-		LcfReader::SetError("This is not a valid RPG2000 map tree.\n");
-		return false;
-	}
-	if (header != "LcfMapTree") {
-		fprintf(stderr, "Warning: This header is not LcfMapTree and might not be a valid RPG2000 map tree.\n");
-	}
-	Data::treemap.lmt_header = std::move(header);
-	TypeReader<RPG::TreeMap>::ReadLcf(Data::treemap, reader, 0);
-	return true;
+	return LoadLcf(reader);
+}
+
+bool LMT_Reader::Load(const char* data, size_t size, const std::string& encoding) {
+	LcfReader reader(data, size, encoding);
+	return LoadLcf(reader);
 }
 
 bool LMT_Reader::Save(std::ostream& filestream, const std::string &encoding, SaveOpt opt) {
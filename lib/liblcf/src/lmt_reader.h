@@ -47,6 +47,11 @@ namespace LMT_Reader {
 	 */
 	bool Load(std::istream& filestream, const std::string &encoding);
 
+	/**
+	 * Loads Map Tree from a buffer holding the whole file.
+	 */
+	bool Load(const char* data, size_t size, const std::string& encoding);
+
 	/**
 	 * Saves Map Tree.
 	 */
@@ -21,12 +21,38 @@ void LMU_Reader::PrepareSave(RPG::Map& map) {
 	++map.save_count;
 }
 
+static std::unique_ptr<RPG::Map> LoadLcf(LcfReader& reader) {
+	if (!reader.IsOk()) {
+		LcfReader::SetError("Couldn't parse map file.\n");
+		return std::unique_ptr<RPG::Map>();
+	}
+	std::string header;
+	reader.ReadString(header, reader.ReadInt());
+	if (header.length() != 10) {
+		LcfReader::SetError("This is not a valid RPG2000 map.\n");
+		return std::unique_ptr<RPG::Map>();
+	}
+	if (header != "LcfMapUnit") {
+		fprintf(stderr, "Warning: This header is not LcfMapUnit and might not be a valid RPG2000 map.\n");
+	}
+
+	auto map = std::unique_ptr<RPG::Map>(new RPG::Map());
+	map->lmu_header = std::move(header);
+	Struct<RPG::Map>::ReadLcf(*map, reader);
+	return map;
+}
+
 std::unique_ptr<RPG::Map> LMU_Reader::Load(const std::string& filename, const std::string& encoding) {
 	std::ifstream stream(filename.c_str(), std::ios::binary);
 	if (!stream.is_open()) {
 		fprintf(stderr, "Failed to open LMU file `%s' for reading : %s\n", filename.c_str(), strerror(errno));
 		return nullptr;
 	}
+	std::vector<char> buffer;
+	if (LcfReader::ReadAll(stream, buffer)) {
+		LcfReader reader(buffer.data(), buffer.size(), encoding);
+		return LoadLcf(reader);
+	}
 	return LMU_Reader::Load(stream, encoding);
 }
 
@@ -59,24 +85,7 @@ std::unique_ptr<RPG::Map> LMU_Reader::LoadXml(const std::string& filename) {
 
 std::unique_ptr<RPG::Map> LMU_Reader::Load(std::istream& filestream, const std::string& encoding) {
 	LcfReader reader(filestream, encoding);
-	if (!reader.IsOk()) {
-		LcfReader::SetError("Couldn't parse map file.\n");
-		return std::unique_ptr<RPG::Map>();
-	}
-	std::string header;
-	reader.ReadString(header, reader.ReadInt());
-	if (header.length() != 10) {
-		LcfReader::SetError("This is not a valid RPG2000 map.\n");
-		return std::unique_ptr<RPG::Map>();
-	}
-	if (header != "LcfMapUnit") {
-		fprintf(stderr, "Warning: This header is not LcfMapUnit and might not be a valid RPG2000 map.\n");
-	}
-
-	auto map = std::unique_ptr<RPG::Map>(new RPG::Map());
-	map->lmu_header = std::move(header);
-	Struct<RPG::Map>::ReadLcf(*map, reader);
-	return map;
+	return LoadLcf(reader);
 }
 
 bool LMU_Reader::Save(std::ostream& filestream, const RPG::Map& map, const std::string& encoding, SaveOpt opt) {
@@ -38,12 +38,36 @@ void LSD_Reader::PrepareSave(RPG::Save& save, int32_t version) {
 	save.easyrpg_data.version = version;
 }
 
+static std::unique_ptr<RPG::Save> LoadLcf(LcfReader& reader) {
+	if (!reader.IsOk()) {
+		LcfReader::SetError("Couldn't parse save file.\n");
+		return std::unique_ptr<RPG::Save>();
+	}
+	std::string header;
+	reader.ReadString(header, reader.ReadInt());
+	if (header.length() != 11) {
+		LcfReader::SetError("This is not a valid RPG2000 save.\n");
+		return std::unique_ptr<RPG::Save>();
+	}
+	if (header != "LcfSaveData") {
+		fprintf(stderr, "Warning: This header is not LcfSaveData and might not be a valid RPG2000 save.\n");
+	}
+	RPG::Save* save = new RPG::Save();
+	Struct<RPG::Save>::ReadLcf(*save, reader);
+	return std::unique_ptr<RPG::Save>(save);
+}
+
 std::unique_ptr<RPG::Save> LSD_Reader::Load(const std::string& filename, const std::string& encoding) {
 	std::ifstream stream(filename.c_str(), std::ios::binary);
 	if (!stream.is_open()) {
 		fprintf(stderr, "Failed to open LSD file `%s' for reading : %s\n", filename.c_str(), strerror(errno));
 		return nullptr;
 	}
+	std::vector<char> buffer;
+	if (LcfReader::ReadAll(stream, buffer)) {
+		LcfReader reader(buffer.data(), buffer.size(), encoding);
+		return LoadLcf(reader);
+	}
 	return LSD_Reader::Load(stream, encoding);
 }
 
@@ -76,22 +100,7 @@ std::unique_ptr<RPG::Save> LSD_Reader::LoadXml(const std::string& filename) {
 
 std::unique_ptr<RPG::Save> LSD_Reader::Load(std::istream& filestream, const std::string &encoding) {
 	LcfReader reader(filestream, encoding);
-	if (!reader.IsOk()) {
-		LcfReader::SetError("Couldn't parse save file.\n");
-		return std::unique_ptr<RPG::Save>();
-	}
-	std::string header;
-	reader.ReadString(header, reader.ReadInt());
-	if (header.length() != 11) {
-		LcfReader::SetError("This is not a valid RPG2000 save.\n");
-		return std::unique_ptr<RPG::Save>();
-	}
-	if (header != "LcfSaveData") {
-		fprintf(stderr, "Warning: This header is not LcfSaveData and might not be a valid RPG2000 save.\n");
-	}
-	RPG::Save* save = new RPG::Save();
-	Struct<RPG::Save>::ReadLcf(*save, reader);
-	return std::unique_ptr<RPG::Save>(save);
+	return LoadLcf(reader);
 }
 
 bool LSD_Reader::Save(std::ostream& filestream, const RPG::Save& save, const std::string &encoding) {
@@ -7,6 +7,7 @@
  * file that was distributed with this source code.
  */
 
+#include <algorithm>
 #include <cstdarg>
 #include <cstdio>
 #include <istream>
@@ -18,7 +19,14 @@
 std::string LcfReader::error_str;
 
 LcfReader::LcfReader(std::istream& filestream, std::string encoding)
-	: stream(filestream)
+	: stream(&filestream)
+	, encoder(std::move(encoding))
+{
+}
+
+LcfReader::LcfReader(const char* data, size_t size, std::string encoding)
+	: data(data)
+	, data_size(size)
 	, encoder(std::move(encoding))
 {
 }
@@ -30,9 +38,29 @@ size_t LcfReader::Read0(void *ptr, size_t size, size_t nmemb) {
 	if (size == 0) { //avoid division by 0
 		return 0;
 	}
-	//Read nmemb elements of size and return the number of read elements
-	stream.read(reinterpret_cast<char*>(ptr), size*nmemb);
-	size_t result = stream.gcount() / size;
+	size_t result;
+	if (stream) {
+		//Read nmemb elements of size and return the number of read elements
+		stream->read(reinterpret_cast<char*>(ptr), size*nmemb);
+		result = stream->gcount() / size;
+	} else {
+		size_t bytes = 0;
+		if (!data_fail) {
+			const size_t available = data_pos < data_size ? data_size - data_pos : 0;
+			bytes = std::min(size * nmemb, available);
+			if (bytes > 0) {
+				memcpy(ptr, data + data_pos, bytes);
+			}
+			data_pos += bytes;
+		}
+		if (bytes != size * nmemb) {
+			if (!data_fail) {
+				data_eof = true;
+			}
+			data_fail = true;
+		}
+		result = bytes / size;
+	}
 #ifdef NDEBUG
 	if (result != nmemb && !Eof()) {
 		perror("Reading error: ");
@@ -79,6 +107,20 @@ void LcfReader::Read<uint32_t>(uint32_t& ref) {
 }
 
 int LcfReader::ReadInt() {
+	if (!stream && !data_fail) {
+		// Fast path decoding directly from memory, falls back for the
+		// end of data and invalid integers to report them the same way
+		int value = 0;
+		for (size_t i = data_pos; i < data_size && i < data_pos + 5; ++i) {
+			const unsigned char temp = data[i];
+			value = (value << 7) | (temp & 0x7F);
+			if (!(temp & 0x80)) {
+				data_pos = i + 1;
+				return value;
+			}
+		}
+	}
+
 	int value = 0;
 	unsigned char temp = 0;
 	int loops = 0;
@@ -111,36 +153,32 @@ void LcfReader::Read<double>(double& ref) {
 }
 
 template <>
-void LcfReader::Read<bool>(std::vector<bool> &buffer, size_t size) {
+void LcfReader::Read<uint8_t>(std::vector<uint8_t> &buffer, size_t size) {
 	buffer.clear();
-
-	for (unsigned i = 0; i < size; ++i) {
-		uint8_t val;
-		Read(&val, 1, 1);
-		buffer.push_back(val > 0);
+	buffer.resize(size);
+	if (size > 0) {
+		Read(buffer.data(), 1, size);
 	}
 }
 
 template <>
-void LcfReader::Read<uint8_t>(std::vector<uint8_t> &buffer, size_t size) {
-	buffer.clear();
+void LcfReader::Read<bool>(std::vector<bool> &buffer, size_t size) {
+	std::vector<uint8_t> bytes;
+	Read(bytes, size);
 
-	for (unsigned int i = 0; i < size; ++i) {
-		uint8_t val;
-		Read(&val, 1, 1);
-		buffer.push_back(val);
-	}
+	buffer.assign(bytes.begin(), bytes.end());
 }
 
 template <>
 void LcfReader::Read<int16_t>(std::vector<int16_t> &buffer, size_t size) {
 	buffer.clear();
 	size_t items = size / 2;
-	for (unsigned int i = 0; i < items; ++i) {
-		int16_t val;
-		Read(&val, 2, 1);
-		SwapByteOrder(val);
-		buffer.push_back(val);
+	buffer.resize(items);
+	if (items > 0) {
+		Read(buffer.data(), 2, items);
+		for (auto& val : buffer) {
+			SwapByteOrder(val);
+		}
 	}
 	if (size % 2 != 0) {
 		Seek(1, FromCurrent);
@@ -152,11 +190,12 @@ template <>
 void LcfReader::Read<int32_t>(std::vector<int32_t> &buffer, size_t size) {
 	buffer.clear();
 	size_t items = size / 4;
-	for (unsigned int i = 0; i < items; ++i) {
-		int32_t val;
-		Read(&val, 4, 1);
-		SwapByteOrder(val);
-		buffer.push_back(val);
+	buffer.resize(items);
+	if (items > 0) {
+		Read(buffer.data(), 4, items);
+		for (auto& val : buffer) {
+			SwapByteOrder(val);
+		}
 	}
 	if (size % 4 != 0) {
 		Seek(size % 4, FromCurrent);
@@ -168,11 +207,12 @@ template <>
 void LcfReader::Read<uint32_t>(std::vector<uint32_t> &buffer, size_t size) {
 	buffer.clear();
 	size_t items = size / 4;
-	for (unsigned int i = 0; i < items; ++i) {
-		uint32_t val;
-		Read(&val, 4, 1);
-		SwapByteOrder(val);
-		buffer.push_back(val);
+	buffer.resize(items);
+	if (items > 0) {
+		Read(buffer.data(), 4, items);
+		for (auto& val : buffer) {
+			SwapByteOrder(val);
+		}
 	}
 	if (size % 4 != 0) {
 		Seek(size % 4, FromCurrent);
@@ -187,23 +227,49 @@ void LcfReader::ReadString(std::string& ref, size_t size) {
 }
 
 bool LcfReader::IsOk() const {
-	return stream.good() && encoder.IsOk();
+	if (stream) {
+		return stream->good() && encoder.IsOk();
+	}
+	return !data_eof && !data_fail && encoder.IsOk();
 }
 
 bool LcfReader::Eof() const {
-	return stream.eof();
+	if (stream) {
+		return stream->eof();
+	}
+	return data_eof;
 }
 
 void LcfReader::Seek(size_t pos, SeekMode mode) {
+	if (!stream) {
+		// Seeking clears eof but does not recover from a failed read
+		data_eof = false;
+		if (data_fail) {
+			return;
+		}
+	}
+
 	switch (mode) {
 	case LcfReader::FromStart:
-		stream.seekg(pos, std::ios_base::beg);
+		if (stream) {
+			stream->seekg(pos, std::ios_base::beg);
+		} else {
+			data_pos = pos;
+		}
 		break;
 	case LcfReader::FromCurrent:
-		stream.seekg(pos, std::ios_base::cur);
+		if (stream) {
+			stream->seekg(pos, std::ios_base::cur);
+		} else {
+			data_pos += pos;
+		}
 		break;
 	case LcfReader::FromEnd:
-		stream.seekg(pos, std::ios_base::end);
+		if (stream) {
+			stream->seekg(pos, std::ios_base::end);
+		} else {
+			data_pos = data_size + pos;
+		}
 		break;
 	default:
 		assert(false && "Invalid SeekMode");
@@ -211,11 +277,24 @@ void LcfReader::Seek(size_t pos, SeekMode mode) {
 }
 
 uint32_t LcfReader::Tell() {
-	return (uint32_t)stream.tellg();
+	if (stream) {
+		return (uint32_t)stream->tellg();
+	}
+	return data_fail ? (uint32_t)-1 : (uint32_t)data_pos;
 }
 
 int LcfReader::Peek() {
-	return stream.peek();
+	if (stream) {
+		return stream->peek();
+	}
+	if (data_fail) {
+		return EOF;
+	}
+	if (data_pos >= data_size) {
+		data_eof = true;
+		return EOF;
+	}
+	return static_cast<unsigned char>(data[data_pos]);
 }
 
 #ifdef _DEBUG
@@ -274,6 +353,29 @@ void LcfReader::Encode(std::string& str) {
 	encoder.Encode(str);
 }
 
+bool LcfReader::ReadAll(std::istream& filestream, std::vector<char>& buffer) {
+	const std::streampos start = filestream.tellg();
+	if (start == std::streampos(-1) || !filestream.seekg(0, std::ios_base::end)) {
+		filestream.clear();
+		return false;
+	}
+	const std::streampos end = filestream.tellg();
+	filestream.seekg(start);
+	if (end == std::streampos(-1) || end < start || !filestream) {
+		filestream.clear();
+		filestream.seekg(start);
+		return false;
+	}
+
+	buffer.resize(static_cast<size_t>(end - start));
+	if (!buffer.empty() && !filestream.read(buffer.data(), buffer.size())) {
+		filestream.clear();
+		filestream.seekg(start);
+		return false;
+	}
+	return true;
+}
+
 int LcfReader::IntSize(unsigned int x) {
 	int result = 0;
 	do {
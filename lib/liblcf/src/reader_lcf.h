@@ -42,6 +42,18 @@ public:
 	 */
 	LcfReader(std::istream& filestream, std::string encoding = "");
 
+	/**
+	 * Constructs a new Reader decoding from memory.
+	 * The data must stay valid while the Reader is used.
+	 * Behaves like reading from a stream with the same content but
+	 * avoids the per read overhead of std::istream.
+	 *
+	 * @param data file content.
+	 * @param size size of data in bytes.
+	 * @param encoding name of the encoding.
+	 */
+	LcfReader(const char* data, size_t size, std::string encoding = "");
+
 	/**
 	 * Destructor. Closes the opened file.
 	 */
@@ -213,9 +225,30 @@ public:
 	 */
 	static int IntSize(unsigned int x);
 
+	/**
+	 * Reads the remaining content of a seekable stream into a buffer
+	 * for decoding from memory.
+	 *
+	 * @param filestream stream to read.
+	 * @param buffer receives the content.
+	 * @return false when the stream is not seekable or reading failed,
+	 *         the stream position is unchanged then.
+	 */
+	static bool ReadAll(std::istream& filestream, std::vector<char>& buffer);
+
 private:
-	/** File-stream managed by this Reader. */
-	std::istream& stream;
+	/** File-stream managed by this Reader, null when reading from memory. */
+	std::istream* stream = nullptr;
+	/** Data when reading from memory */
+	const char* data = nullptr;
+	/** Size of data */
+	size_t data_size = 0;
+	/** Read position in data, can be behind the end after seeking */
+	size_t data_pos = 0;
+	/** Like the eofbit of a stream: Read or peeked behind the end */
+	bool data_eof = false;
+	/** Like the failbit of a stream: A read was incomplete, sticky */
+	bool data_fail = false;
 	/** Contains the last set error. */
 	static std::string error_str;
 	/** The internal Encoder */
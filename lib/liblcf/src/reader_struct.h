@@ -385,6 +385,12 @@ struct DatabaseVersionField : public TypedField<S,T> {
 
 	using TypedField<S,T>::TypedField;
 
+	void WriteLcf(const S& obj, LcfWriter& stream) const {
+		if ((obj.*(this->ref)) == 0) {
+			return;
+		}
+		TypedField<S,T>::WriteLcf(obj, stream);
+	}
 	int LcfSize(const S& obj, LcfWriter& stream) const {
 		//If db version is 0, it's like a "version block" is not present.
 		if ((obj.*(this->ref)) == 0) {
@@ -551,7 +557,7 @@ struct StringComparator {
 template <class S>
 class Struct {
 private:
-	typedef std::map<int, const Field<S>* > field_map_type;
+	typedef std::vector<const Field<S>* > field_map_type;
 	typedef std::map<const char* const, const Field<S>*, StringComparator> tag_map_type;
 	typedef IDReaderT<S, IDChecker<S>::value > IDReader;
 	static const Field<S>* fields[];
@@ -581,7 +587,7 @@ public:
 };
 
 template <class S>
-std::map<int, const Field<S>* > Struct<S>::field_map;
+std::vector<const Field<S>* > Struct<S>::field_map;
 
 template <class S>
 std::map<const char* const, const Field<S>*, StringComparator> Struct<S>::tag_map;
@@ -7,6 +7,7 @@
  * file that was distributed with this source code.
  */
 
+#include <algorithm>
 #include <cstring>
 #include <iostream>
 #include <iomanip>
@@ -25,6 +26,11 @@ template <class S>
 void Struct<S>::MakeFieldMap() {
 	if (!field_map.empty())
 		return;
+	// Chunk IDs are small, a table indexed by ID avoids a map lookup per chunk
+	int max_id = 0;
+	for (int i = 0; fields[i] != NULL; i++)
+		max_id = std::max(max_id, fields[i]->id);
+	field_map.resize(max_id + 1);
 	for (int i = 0; fields[i] != NULL; i++)
 		field_map[fields[i]->id] = fields[i];
 }
@@ -66,17 +72,17 @@ void Struct<S>::ReadLcf(S& obj, LcfReader& stream) {
 
 		chunk_info.length = stream.ReadInt();
 
-		auto it = field_map.find(chunk_info.ID);
-		if (it != field_map.end()) {
+		const Field<S>* field = chunk_info.ID < field_map.size() ? field_map[chunk_info.ID] : nullptr;
+		if (field != nullptr) {
 #ifdef LCF_DEBUG_TRACE
-			printf("0x%02x (size: %" PRIu32 ", pos: 0x%" PRIx32 "): %s\n", chunk_info.ID, chunk_info.length, stream.Tell(), it->second->name);
+			printf("0x%02x (size: %" PRIu32 ", pos: 0x%" PRIx32 "): %s\n", chunk_info.ID, chunk_info.length, stream.Tell(), field->name);
 #endif
 			const uint32_t off = stream.Tell();
-			it->second->ReadLcf(obj, stream, chunk_info.length);
+			field->ReadLcf(obj, stream, chunk_info.length);
 			const uint32_t bytes_read = stream.Tell() - off;
 			if (bytes_read != chunk_info.length) {
 				fprintf(stderr, "Warning: Corrupted Chunk 0x%02" PRIx32 " (size: %" PRIu32 ", pos: 0x%" PRIx32 "): %s : Read %" PRIu32 " bytes! Reseting...\n",
-						chunk_info.ID, chunk_info.length, off, it->second->name, bytes_read);
+						chunk_info.ID, chunk_info.length, off, field->name, bytes_read);
 				stream.Seek(off + chunk_info.length);
 			}
 		}
@@ -120,11 +126,11 @@ void Struct<S>::WriteLcf(const S& obj, LcfWriter& stream) {
 			continue;
 		}
 		stream.WriteInt(field->id);
-		auto len = field->LcfSize(obj, stream);
-		stream.WriteInt(len);
-		if (len > 0) {
-			field->WriteLcf(obj, stream);
-		}
+		// The length is put in front when the chunk ends, sizing the
+		// field beforehand would size all nested structs again
+		stream.BeginChunk();
+		field->WriteLcf(obj, stream);
+		stream.EndChunk();
 	}
 	// Writing a 0-byte after RPG::Database or RPG::Save breaks the parser in RPG_RT
 	conditional_zero_writer<S>(stream);
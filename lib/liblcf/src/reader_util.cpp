@@ -36,7 +36,9 @@
 #include <algorithm>
 #include <cstdio>
 #include <cstdlib>
+#include <mutex>
 #include <sstream>
+#include <unordered_map>
 #include <vector>
 
 #include "data.h"
@@ -287,49 +289,66 @@ std::string ReaderUtil::Recode(const std::string& str_to_encode, const std::stri
 	return ReaderUtil::Recode(str_to_encode, source_encoding, "UTF-8");
 }
 
-std::string ReaderUtil::Recode(const std::string& str_to_encode,
-                               const std::string& src_enc,
-                               const std::string& dst_enc) {
+namespace {
+	/** Converters between two encodings */
+	struct Converter {
+#ifdef LCF_SUPPORT_ICU
+		UConverter* from = nullptr;
+		UConverter* to = nullptr;
+#else
+		iconv_t cd = (iconv_t)-1;
+#endif
+		bool ok = false;
+		/** Whether ASCII characters are the same in both encodings */
+		bool ascii_compatible = false;
+	};
+
+	/**
+	 * Converters stay open for the lifetime of the program, opening them
+	 * for every string is much slower than the conversion itself.
+	 * Converters are not thread-safe, the mutex guards their use.
+	 */
+	struct ConverterCache {
+		std::mutex mutex;
+		std::unordered_map<std::string, Converter> converters;
+
+		~ConverterCache() {
+			for (auto& it : converters) {
+				Converter& conv = it.second;
+#ifdef LCF_SUPPORT_ICU
+				if (conv.from) ucnv_close(conv.from);
+				if (conv.to) ucnv_close(conv.to);
+#else
+				if (conv.cd != (iconv_t)-1) iconv_close(conv.cd);
+#endif
+			}
+		}
+	};
 
-	if (src_enc.empty() || dst_enc.empty() || str_to_encode.empty()) {
-		return str_to_encode;
+	ConverterCache& GetConverterCache() {
+		static ConverterCache cache;
+		return cache;
 	}
+}
 
-	auto src_cp = atoi(src_enc.c_str());
-	const auto& src_enc_str = src_cp > 0
-		? ReaderUtil::CodepageToEncoding(src_cp)
-		: src_enc;
-
-	auto dst_cp = atoi(dst_enc.c_str());
-	const auto& dst_enc_str = dst_cp > 0
-		? ReaderUtil::CodepageToEncoding(dst_cp)
-		: dst_enc;
+static bool IsAscii(const std::string& str) {
+	for (unsigned char c : str) {
+		if (c >= 0x80) {
+			return false;
+		}
+	}
+	return true;
+}
 
+static bool Convert(Converter& conv, const std::string& str_to_encode, std::string& result) {
 #ifdef LCF_SUPPORT_ICU
 	auto status = U_ZERO_ERROR;
-	auto conv_from = ucnv_open(src_enc_str.c_str(), &status);
 
-	if (status != U_ZERO_ERROR && status != U_AMBIGUOUS_ALIAS_WARNING) {
-		fprintf(stderr, "liblcf:  ucnv_open() error for source encoding \"%s\": %s\n", src_enc_str.c_str(), u_errorName(status));
-		return std::string();
-	}
-	status = U_ZERO_ERROR;
-	auto conv_from_sg = makeScopeGuard([&]() { ucnv_close(conv_from); });
-
-	auto conv_to = ucnv_open(dst_enc_str.c_str(), &status);
-
-	if (status != U_ZERO_ERROR && status != U_AMBIGUOUS_ALIAS_WARNING) {
-		fprintf(stderr, "liblcf:  ucnv_open() error for dest encoding \"%s\": %s\n", dst_enc_str.c_str(), u_errorName(status));
-		return std::string();
-	}
-	auto conv_to_sg = makeScopeGuard([&]() { ucnv_close(conv_to); });
-	status = U_ZERO_ERROR;
-
-	std::string result(str_to_encode.size() * 4, '\0');
+	result.assign(str_to_encode.size() * 4, '\0');
 	auto* src = &str_to_encode.front();
 	auto* dst = &result.front();
 
-	ucnv_convertEx(conv_to, conv_from,
+	ucnv_convertEx(conv.to, conv.from,
 			&dst, dst + result.size(),
 			&src, src + str_to_encode.size(),
 			nullptr, nullptr, nullptr, nullptr,
@@ -338,56 +357,153 @@ std::string ReaderUtil::Recode(const std::string& str_to_encode,
 
 	if (U_FAILURE(status)) {
 		fprintf(stderr, "liblcf: ucnv_convertEx() error when encoding \"%s\": %s\n", str_to_encode.c_str(), u_errorName(status));
-		return std::string();
+		return false;
 	}
 
 	result.resize(dst - result.c_str());
 	result.shrink_to_fit();
-
-	return result;
+	return true;
 #else
-	iconv_t cd = iconv_open(dst_enc_str.c_str(), src_enc_str.c_str());
-	if (cd == (iconv_t)-1)
-		return str_to_encode;
+	// Reset the shift state left by the previous conversion
+	iconv(conv.cd, nullptr, nullptr, nullptr, nullptr);
+
 	char *src = const_cast<char *>(str_to_encode.c_str());
 	size_t src_left = str_to_encode.size();
 	size_t dst_size = str_to_encode.size() * 5 + 10;
-	char *dst = new char[dst_size];
+	std::vector<char> dst(dst_size);
 	size_t dst_left = dst_size;
 #    ifdef ICONV_CONST
 	char ICONV_CONST *p = src;
 #    else
 	char *p = src;
 #    endif
-	char *q = dst;
-	size_t status = iconv(cd, &p, &src_left, &q, &dst_left);
-	iconv_close(cd);
+	char *q = dst.data();
+	size_t status = iconv(conv.cd, &p, &src_left, &q, &dst_left);
 	if (status == (size_t) -1 || src_left > 0) {
-		delete[] dst;
+		return false;
+	}
+	result.assign(dst.data(), dst_size - dst_left);
+	return true;
+#endif
+}
+
+/**
+ * Gets the cached converters for an encoding pair and opens them on
+ * first use. The cache mutex must be held.
+ */
+static Converter& GetConverter(const std::string& src_enc, const std::string& dst_enc) {
+	auto& converters = GetConverterCache().converters;
+
+	const std::string key = src_enc + '\n' + dst_enc;
+	auto it = converters.find(key);
+	if (it != converters.end()) {
+		return it->second;
+	}
+
+	Converter& conv = converters[key];
+
+	auto src_cp = atoi(src_enc.c_str());
+	const auto& src_enc_str = src_cp > 0
+		? ReaderUtil::CodepageToEncoding(src_cp)
+		: src_enc;
+
+	auto dst_cp = atoi(dst_enc.c_str());
+	const auto& dst_enc_str = dst_cp > 0
+		? ReaderUtil::CodepageToEncoding(dst_cp)
+		: dst_enc;
+
+#ifdef LCF_SUPPORT_ICU
+	auto status = U_ZERO_ERROR;
+	conv.from = ucnv_open(src_enc_str.c_str(), &status);
+
+	if (status != U_ZERO_ERROR && status != U_AMBIGUOUS_ALIAS_WARNING) {
+		fprintf(stderr, "liblcf:  ucnv_open() error for source encoding \"%s\": %s\n", src_enc_str.c_str(), u_errorName(status));
+		return conv;
+	}
+	status = U_ZERO_ERROR;
+
+	conv.to = ucnv_open(dst_enc_str.c_str(), &status);
+
+	if (status != U_ZERO_ERROR && status != U_AMBIGUOUS_ALIAS_WARNING) {
+		fprintf(stderr, "liblcf:  ucnv_open() error for dest encoding \"%s\": %s\n", dst_enc_str.c_str(), u_errorName(status));
+		return conv;
+	}
+#else
+	conv.cd = iconv_open(dst_enc_str.c_str(), src_enc_str.c_str());
+	if (conv.cd == (iconv_t)-1) {
+		return conv;
+	}
+#endif
+	conv.ok = true;
+
+	// Some encodings replace ASCII characters, e.g. the backslash in Shift-JIS
+	std::string ascii;
+	for (int c = 1; c <= 0x7F; ++c) {
+		ascii.push_back(static_cast<char>(c));
+	}
+	std::string result;
+	conv.ascii_compatible = Convert(conv, ascii, result) && result == ascii;
+
+	return conv;
+}
+
+std::string ReaderUtil::Recode(const std::string& str_to_encode,
+                               const std::string& src_enc,
+                               const std::string& dst_enc) {
+
+	if (src_enc.empty() || dst_enc.empty() || str_to_encode.empty()) {
+		return str_to_encode;
+	}
+
+	std::lock_guard<std::mutex> lock(GetConverterCache().mutex);
+
+	Converter& conv = GetConverter(src_enc, dst_enc);
+	if (!conv.ok) {
+#ifdef LCF_SUPPORT_ICU
+		return std::string();
+#else
+		return str_to_encode;
+#endif
+	}
+
+	if (conv.ascii_compatible && IsAscii(str_to_encode)) {
+		return str_to_encode;
+	}
+
+	std::string result;
+	if (!Convert(conv, str_to_encode, result)) {
 		return std::string();
 	}
-	*q++ = '\0';
-	std::string result(dst);
-	delete[] dst;
 	return result;
-#endif
 }
 
 std::string ReaderUtil::Normalize(const std::string &str) {
+	if (IsAscii(str)) {
+		// Lowercasing is all the normalization does to ASCII
+		std::string result = str;
+		for (char& c : result) {
+			if (c >= 'A' && c <= 'Z') {
+				c += 'a' - 'A';
+			}
+		}
+		return result;
+	}
+
 #ifdef LCF_SUPPORT_ICU
 	icu::UnicodeString uni = icu::UnicodeString(str.c_str(), "utf-8").toLower();
-	UErrorCode err = U_ZERO_ERROR;
 	std::string res;
-	const icu::Normalizer2* norm = icu::Normalizer2::getNFKCInstance(err);
-	if (U_FAILURE(err)) {
+	static UErrorCode norm_err = U_ZERO_ERROR;
+	static const icu::Normalizer2* norm = icu::Normalizer2::getNFKCInstance(norm_err);
+	if (U_FAILURE(norm_err)) {
 		static bool err_reported = false;
 		if (!err_reported) {
-			fprintf(stderr, "Normalizer2::getNFKCInstance failed (%s). \"nrm\" is probably missing in the ICU data file. Unicode normalization will not work!\n", u_errorName(err));
+			fprintf(stderr, "Normalizer2::getNFKCInstance failed (%s). \"nrm\" is probably missing in the ICU data file. Unicode normalization will not work!\n", u_errorName(norm_err));
 			err_reported = true;
 		}
 		uni.toUTF8String(res);
 		return res;
 	}
+	UErrorCode err = U_ZERO_ERROR;
 	icu::UnicodeString f = norm->normalize(uni, err);
 	if (U_FAILURE(err)) {
 		uni.toUTF8String(res);
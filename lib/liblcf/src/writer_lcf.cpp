@@ -22,10 +22,30 @@ LcfWriter::~LcfWriter() {
 }
 
 void LcfWriter::Write(const void *ptr, size_t size, size_t nmemb) {
-	stream.write(reinterpret_cast<const char*>(ptr), size*nmemb);
+	const char* data = reinterpret_cast<const char*>(ptr);
+	if (!chunks.empty()) {
+		buffer.insert(buffer.end(), data, data + size*nmemb);
+		return;
+	}
+	stream.write(data, size*nmemb);
 	assert(stream.good());
 }
 
+/**
+ * Encodes a compressed integer.
+ *
+ * @param value the integer.
+ * @param out receives up to 5 bytes.
+ * @return number of bytes.
+ */
+static int EncodeInt(uint32_t value, uint8_t* out) {
+	int n = 0;
+	for (int i = 28; i >= 0; i -= 7)
+		if (value >= (1U << i) || i == 0)
+			out[n++] = (uint8_t)(((value >> i) & 0x7F) | (i > 0 ? 0x80 : 0));
+	return n;
+}
+
 template <>
 void LcfWriter::Write<int8_t>(int8_t val) {
 	Write(&val, 1, 1);
@@ -49,10 +69,28 @@ void LcfWriter::Write<uint32_t>(uint32_t val) {
 }
 
 void LcfWriter::WriteInt(int val) {
-	uint32_t value = (uint32_t) val;
-	for (int i = 28; i >= 0; i -= 7)
-		if (value >= (1U << i) || i == 0)
-			Write<uint8_t>((uint8_t)(((value >> i) & 0x7F) | (i > 0 ? 0x80 : 0)));
+	uint8_t bytes[5];
+	Write(bytes, 1, EncodeInt((uint32_t) val, bytes));
+}
+
+void LcfWriter::BeginChunk() {
+	chunks.push_back(buffer.size());
+}
+
+void LcfWriter::EndChunk() {
+	assert(!chunks.empty());
+	const size_t start = chunks.back();
+	chunks.pop_back();
+
+	uint8_t length[5];
+	const int n = EncodeInt((uint32_t)(buffer.size() - start), length);
+	buffer.insert(buffer.begin() + start, length, length + n);
+
+	if (chunks.empty()) {
+		stream.write(buffer.data(), buffer.size());
+		assert(stream.good());
+		buffer.clear();
+	}
 }
 
 template <>
@@ -119,7 +157,7 @@ void LcfWriter::Write(const std::string& _str) {
 }
 
 uint32_t LcfWriter::Tell() {
-	return (uint32_t)stream.tellp();
+	return (uint32_t)stream.tellp() + buffer.size();
 }
 
 bool LcfWriter::IsOk() const {
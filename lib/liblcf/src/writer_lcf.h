@@ -80,6 +80,20 @@ public:
 	template <class T>
 	void Write(const std::vector<T>& buffer);
 
+	/**
+	 * Starts a chunk of unknown length.
+	 * Everything written until the matching EndChunk is buffered.
+	 * Chunks can be nested.
+	 */
+	void BeginChunk();
+
+	/**
+	 * Ends the chunk started by the last BeginChunk and puts its
+	 * length as compressed integer in front of the chunk data.
+	 * The data is written to the stream when the outermost chunk ends.
+	 */
+	void EndChunk();
+
 	/**
 	 * Returns the current position of the read pointer in
 	 * the stream.
@@ -109,6 +123,10 @@ private:
 	std::ostream& stream;
 	/** Encoder object */
 	Encoder encoder;
+	/** Data of the open chunks */
+	std::vector<char> buffer;
+	/** Start offsets of the open chunks in buffer */
+	std::vector<size_t> chunks;
 
 	/**
 	 * Converts a 16bit signed integer to/from little-endian.
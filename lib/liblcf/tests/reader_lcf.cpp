@@ -0,0 +1,102 @@
+/*
+ * This file is part of liblcf. Copyright (c) 2019 liblcf authors.
+ * https://github.com/EasyRPG/liblcf - https://easyrpg.org
+ *
+ * liblcf is Free/Libre Open Source Software, released under the MIT License.
+ * For the full copyright and license information, please view the COPYING
+ * file that was distributed with this source code.
+ */
+
+#include <sstream>
+#include "reader_lcf.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("reader_lcf");
+
+namespace {
+// Compressed integers 0x7F, 0x80, 0x3FFF and 0x12345, a string,
+// an int16 array with an odd size and an uint32
+const std::string sample(
+	"\x7F" "\x81\x00" "\xFF\x7F" "\x84\xC6\x45"
+	"\x03" "abc"
+	"\x01\x00\xFF\xFF\x07"
+	"\x78\x56\x34\x12", 21);
+
+struct Readers {
+	std::istringstream stream { sample };
+	LcfReader from_stream { stream };
+	LcfReader from_memory { sample.data(), sample.size() };
+};
+}
+
+TEST_CASE("Memory and stream read the same") {
+	Readers r;
+
+	for (LcfReader* reader : { &r.from_stream, &r.from_memory }) {
+		REQUIRE(reader->IsOk());
+		REQUIRE_EQ(reader->ReadInt(), 0x7F);
+		REQUIRE_EQ(reader->ReadInt(), 0x80);
+		REQUIRE_EQ(reader->ReadInt(), 0x3FFF);
+		REQUIRE_EQ(reader->ReadInt(), 0x12345);
+		REQUIRE_EQ(reader->Tell(), 8);
+
+		std::string str;
+		reader->ReadString(str, reader->ReadInt());
+		REQUIRE_EQ(str, "abc");
+
+		REQUIRE_EQ(reader->Peek(), 0x01);
+		std::vector<int16_t> shorts;
+		reader->Read(shorts, 5);
+		REQUIRE_EQ(shorts, std::vector<int16_t>{ 1, -1, 0 });
+
+		uint32_t value;
+		reader->Read(value);
+		REQUIRE_EQ(value, 0x12345678u);
+		REQUIRE(reader->IsOk());
+		REQUIRE(!reader->Eof());
+	}
+}
+
+TEST_CASE("Memory and stream handle the end the same") {
+	Readers r;
+
+	for (LcfReader* reader : { &r.from_stream, &r.from_memory }) {
+		reader->Seek(0, LcfReader::FromEnd);
+		REQUIRE_EQ(reader->Tell(), sample.size());
+		REQUIRE(!reader->Eof());
+
+		// Peeking at the end sets eof, seeking clears it
+		REQUIRE_EQ(reader->Peek(), EOF);
+		REQUIRE(reader->Eof());
+		reader->Seek(sample.size() - 2);
+		REQUIRE(!reader->Eof());
+
+		// Incomplete read, the reader stays failed
+		uint32_t value = 0;
+		reader->Read(value);
+		REQUIRE(reader->Eof());
+		REQUIRE(!reader->IsOk());
+		REQUIRE_EQ(reader->ReadInt(), 0);
+
+		reader->Seek(0);
+		REQUIRE(!reader->Eof());
+		REQUIRE(!reader->IsOk());
+		REQUIRE_EQ(reader->Tell(), (uint32_t)-1);
+		REQUIRE_EQ(reader->ReadInt(), 0);
+		REQUIRE(!reader->Eof());
+	}
+}
+
+TEST_CASE("ReadAll keeps the stream position") {
+	std::istringstream stream(sample);
+	stream.seekg(5);
+
+	std::vector<char> buffer;
+	REQUIRE(LcfReader::ReadAll(stream, buffer));
+	REQUIRE_EQ(std::string(buffer.begin(), buffer.end()), sample.substr(5));
+
+	LcfReader reader(buffer.data(), buffer.size());
+	REQUIRE_EQ(reader.ReadInt(), 0x12345);
+}
+
+TEST_SUITE_END();
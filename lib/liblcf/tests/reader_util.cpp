@@ -0,0 +1,30 @@
+/*
+ * This file is part of liblcf. Copyright (c) 2019 liblcf authors.
+ * https://github.com/EasyRPG/liblcf - https://easyrpg.org
+ *
+ * liblcf is Free/Libre Open Source Software, released under the MIT License.
+ * For the full copyright and license information, please view the COPYING
+ * file that was distributed with this source code.
+ */
+
+#include "reader_util.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("reader_util");
+
+TEST_CASE("Recode") {
+	REQUIRE_EQ(ReaderUtil::Recode("Actor1", "1252"), "Actor1");
+	REQUIRE_EQ(ReaderUtil::Recode("caf\xe9", "1252"), "caf\xc3\xa9");
+	REQUIRE_EQ(ReaderUtil::Recode("caf\xc3\xa9", "UTF-8", "1252"), "caf\xe9");
+	// Repeated to use the cached converters
+	REQUIRE_EQ(ReaderUtil::Recode("caf\xe9", "1252"), "caf\xc3\xa9");
+	REQUIRE_EQ(ReaderUtil::Recode("\xef\xff", "1251"), "\xd0\xbf\xd1\x8f");
+	REQUIRE_EQ(ReaderUtil::Recode("Actor1", ""), "Actor1");
+}
+
+TEST_CASE("Normalize") {
+	REQUIRE_EQ(ReaderUtil::Normalize("Picture/MiXeD.png"), "picture/mixed.png");
+	REQUIRE_EQ(ReaderUtil::Normalize("CAF\xc3\xa9"), "caf\xc3\xa9");
+}
+
+TEST_SUITE_END();
@@ -17,30 +17,316 @@
 
 #include "system.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cstring>
 #include <cassert>
+#include <iterator>
+#include <system_error>
 #include "audio_generic.h"
+#include "audio_kernels.h"
 #include "filefinder.h"
 #include "output.h"
+#include "player.h"
+#include "profiler.h"
+
+/**
+ * BGM decoder with a ring buffer of decoded PCM data.
+ *
+ * When decoding ahead the decode thread fills the ring buffer and the mixer
+ * only copies from it. The stream positions where the decoder reported new
+ * ticks and loop counts are queued alongside, so the mixer reports them when
+ * the data is actually played and not when it was decoded.
+ * Volume and fade of the decoder are only used by the mixer, the decode
+ * thread never touches them.
+ *
+ * Without decoding ahead the mixer decodes directly.
+ */
+class GenericAudio::BgmStream {
+public:
+	BgmStream(std::unique_ptr<AudioDecoder> decoder, int buffer_ms);
+
+	/** Decode thread: Decodes until the ring buffer is filled. */
+	void Fill();
+
+	/**
+	 * Mixer: Reads decoded data. When decoding ahead and the ring buffer
+	 * ran empty the remaining data is silence.
+	 *
+	 * @param buffer output buffer
+	 * @param length bytes to read
+	 * @return bytes read or -1 on error
+	 */
+	int Read(uint8_t* buffer, int length);
+
+	/** Mixer: Changes the pitch and drops the data decoded with the old pitch. */
+	void SetPitch(int pitch);
+
+	/** Mixer: Ticks of the data read last */
+	int GetTicks() const;
+
+	/** Mixer: Loop count of the data read last */
+	int GetLoopCount() const;
+
+	void GetFormat(int& frequency, AudioDecoder::Format& format, int& channels) const;
+
+	/** Decoder for volume and fade changes by the mixer */
+	AudioDecoder& GetDecoder();
+
+	/** Whether the decode thread fills the stream */
+	bool IsDecodedAhead() const;
+
+	/** Set by the mixer when the stream is not played anymore */
+	std::atomic<bool> stopped;
+
+private:
+	/** Position in the stream with the decoder state reached there */
+	struct Position {
+		uint64_t pos;
+		int ticks;
+		int loop_count;
+	};
+
+	std::unique_ptr<AudioDecoder> decoder;
+	int frequency = 0;
+	AudioDecoder::Format format = AudioDecoder::Format::S16;
+	int channels = 0;
+
+	std::vector<uint8_t> ring;
+	/** Bytes the decode thread keeps buffered */
+	size_t target_size = 0;
+	/** Bytes decoded at once, a fraction of the ring buffer */
+	size_t chunk_size = 0;
+	/** Bytes ever read by the mixer, written by the mixer */
+	std::atomic<uint64_t> read_pos;
+	/** Bytes ever decoded, written by the decode thread */
+	std::atomic<uint64_t> write_pos;
+	/** Pitch to apply before decoding more data, -1 when unchanged */
+	std::atomic<int> pending_pitch;
+	/** Number of pitch changes requested, written by the mixer */
+	std::atomic<unsigned> flush_request;
+	/** Number of pitch changes applied by Fill, written by the decode thread */
+	std::atomic<unsigned> flush_done;
+	/** Data before this position was decoded with an old pitch */
+	std::atomic<uint64_t> discard_pos;
+	std::atomic<bool> error;
+
+	static const unsigned position_queue_size = 64;
+	std::array<Position, position_queue_size> positions;
+	std::atomic<unsigned> positions_read;
+	std::atomic<unsigned> positions_write;
+
+	// Mixer state
+	int ticks = 0;
+	int loop_count = 0;
+};
+
+GenericAudio::BgmStream::BgmStream(std::unique_ptr<AudioDecoder> decoder, int buffer_ms) :
+	stopped(false), decoder(std::move(decoder)), read_pos(0), write_pos(0),
+	pending_pitch(-1), flush_request(0), flush_done(0), discard_pos(0),
+	error(false), positions_read(0), positions_write(0) {
+	this->decoder->GetFormat(frequency, format, channels);
+
+	if (buffer_ms <= 0) {
+		return;
+	}
+
+	const size_t frame_size = AudioDecoder::GetSamplesizeForFormat(format) * channels;
+	const size_t target_frames = static_cast<size_t>(frequency) * buffer_ms / 1000;
+
+	// Keep the number of chunks in the ring buffer below the position queue size
+	chunk_size = std::max<size_t>(1024, target_frames / 32) * frame_size;
+	target_size = std::max(target_frames * frame_size, chunk_size);
+	ring.resize((target_size + chunk_size - 1) / chunk_size * chunk_size + 2 * chunk_size);
+}
+
+void GenericAudio::BgmStream::Fill() {
+	uint64_t write = write_pos.load(std::memory_order_relaxed);
+	for (;;) {
+		// Checked before every chunk, a pitch change requested while decoding
+		// the previous chunk also drops that chunk
+		const unsigned request = flush_request.load(std::memory_order_acquire);
+		if (request != flush_done.load(std::memory_order_relaxed)) {
+			const int pitch = pending_pitch.exchange(-1, std::memory_order_acquire);
+			if (pitch >= 0) {
+				decoder->SetPitch(pitch);
+			}
+			discard_pos.store(write, std::memory_order_relaxed);
+			flush_done.store(request, std::memory_order_release);
+		}
+
+		if (error.load(std::memory_order_relaxed)) {
+			break;
+		}
+
+		const size_t buffered = static_cast<size_t>(write - read_pos.load(std::memory_order_acquire));
+		if (buffered >= target_size || ring.size() - buffered < chunk_size) {
+			break;
+		}
+
+		const size_t offset = write % ring.size();
+		const int length = static_cast<int>(std::min(chunk_size, ring.size() - offset));
+		const int bytes = decoder->Decode(&ring[offset], length);
+		if (bytes < 0) {
+			error.store(true, std::memory_order_release);
+			break;
+		}
+		if (bytes == 0) {
+			break;
+		}
+
+		write += bytes;
+
+		const unsigned pos_write = positions_write.load(std::memory_order_relaxed);
+		if (pos_write - positions_read.load(std::memory_order_acquire) < position_queue_size) {
+			positions[pos_write % position_queue_size] = { write, decoder->GetTicks(), decoder->GetLoopCount() };
+			positions_write.store(pos_write + 1, std::memory_order_release);
+		}
+
+		write_pos.store(write, std::memory_order_release);
+	}
+}
+
+int GenericAudio::BgmStream::Read(uint8_t* buffer, int length) {
+	if (!IsDecodedAhead()) {
+		const int bytes = decoder->Decode(buffer, length);
+		ticks = decoder->GetTicks();
+		loop_count = decoder->GetLoopCount();
+		return bytes;
+	}
+
+	if (flush_request.load(std::memory_order_relaxed) != flush_done.load(std::memory_order_acquire)) {
+		// The decode thread did not apply the new pitch yet
+		memset(buffer, '\0', length);
+		return length;
+	}
+
+	uint64_t read = std::max(read_pos.load(std::memory_order_relaxed), discard_pos.load(std::memory_order_relaxed));
+	const uint64_t write = write_pos.load(std::memory_order_acquire);
+
+	const size_t available = static_cast<size_t>(write - read);
+	if (available == 0 && error.load(std::memory_order_acquire)) {
+		return -1;
+	}
+
+	const size_t bytes = std::min<size_t>(length, available);
+	const size_t offset = read % ring.size();
+	const size_t first = std::min(bytes, ring.size() - offset);
+	memcpy(buffer, &ring[offset], first);
+	memcpy(buffer + first, ring.data(), bytes - first);
+	if (bytes < static_cast<size_t>(length)) {
+		// Underrun, the decode thread fell behind
+		memset(buffer + bytes, '\0', length - bytes);
+	}
+
+	read += bytes;
+	read_pos.store(read, std::memory_order_release);
+
+	unsigned pos_read = positions_read.load(std::memory_order_relaxed);
+	const unsigned pos_write = positions_write.load(std::memory_order_acquire);
+	for (; pos_read != pos_write; ++pos_read) {
+		const Position& position = positions[pos_read % position_queue_size];
+		if (position.pos > read) {
+			break;
+		}
+		ticks = position.ticks;
+		loop_count = position.loop_count;
+	}
+	positions_read.store(pos_read, std::memory_order_release);
+
+	return length;
+}
+
+void GenericAudio::BgmStream::SetPitch(int pitch) {
+	if (!IsDecodedAhead()) {
+		decoder->SetPitch(pitch);
+		return;
+	}
+
+	// The decode thread applies the pitch and marks the data decoded so far
+	// for discarding, Read outputs silence until then
+	pending_pitch.store(pitch, std::memory_order_release);
+	flush_request.fetch_add(1, std::memory_order_release);
+	decode_cv.notify_one();
+}
+
+int GenericAudio::BgmStream::GetTicks() const {
+	return ticks;
+}
+
+int GenericAudio::BgmStream::GetLoopCount() const {
+	return loop_count;
+}
+
+void GenericAudio::BgmStream::GetFormat(int& frequency, AudioDecoder::Format& format, int& channels) const {
+	frequency = this->frequency;
+	format = this->format;
+	channels = this->channels;
+}
+
+AudioDecoder& GenericAudio::BgmStream::GetDecoder() {
+	return *decoder;
+}
+
+bool GenericAudio::BgmStream::IsDecodedAhead() const {
+	return !ring.empty();
+}
 
 GenericAudio::BgmChannel GenericAudio::BGM_Channels[nr_of_bgm_channels];
 GenericAudio::SeChannel GenericAudio::SE_Channels[nr_of_se_channels];
-bool GenericAudio::BGM_PlayedOnceIndicator;
 bool GenericAudio::Muted = false;
 
+std::array<GenericAudio::Command, GenericAudio::command_queue_size> GenericAudio::commands;
+std::atomic<unsigned> GenericAudio::command_read(0);
+std::atomic<unsigned> GenericAudio::command_write(0);
+
+bool GenericAudio::bgm_playing = false;
+uint32_t GenericAudio::bgm_generation = 0;
+uint32_t GenericAudio::mixer_bgm_generation = 0;
+bool GenericAudio::mixer_bgm_played_once = false;
+std::atomic<uint64_t> GenericAudio::bgm_state(0);
+std::atomic<unsigned> GenericAudio::se_dropped(0);
+
+int GenericAudio::decode_ahead_ms = 0;
+std::thread GenericAudio::decode_thread;
+std::mutex GenericAudio::decode_mutex;
+std::condition_variable GenericAudio::decode_cv;
+std::vector<GenericAudio::BgmStreamRef> GenericAudio::decode_streams;
+bool GenericAudio::decode_quit = false;
+
 std::vector<int16_t> GenericAudio::sample_buffer;
 std::vector<uint8_t> GenericAudio::scrap_buffer;
 unsigned GenericAudio::scrap_buffer_size = 0;
 std::vector<float> GenericAudio::mixer_buffer;
 
+namespace {
+	constexpr uint32_t generation_mask = 0x7FFFFFFF;
+}
+
 GenericAudio::GenericAudio() {
 	for (unsigned i = 0; i < nr_of_bgm_channels; i++) {
-		BGM_Channels[i].decoder.reset();
+		BGM_Channels[i].stream.reset();
 	}
 	for (unsigned i = 0; i < nr_of_se_channels; i++) {
 		SE_Channels[i].se.reset();
 	}
-	BGM_PlayedOnceIndicator = false;
+	for (auto& cmd : commands) {
+		cmd = Command();
+	}
+	command_read = 0;
+	command_write = 0;
+	bgm_playing = false;
+	bgm_generation = 0;
+	mixer_bgm_generation = 0;
+	mixer_bgm_played_once = false;
+	bgm_state = 0;
+	se_dropped = 0;
+#if defined(EMSCRIPTEN) && !defined(__EMSCRIPTEN_PTHREADS__)
+	// Built without thread support
+	decode_ahead_ms = 0;
+#else
+	decode_ahead_ms = Player::bgm_buffer_ms;
+#endif
 
 	// Initialize to some arbitrary (low-quality) format to prevent crashes
 	// when the inheriting class doesn't call SetFormat
@@ -48,194 +334,362 @@ GenericAudio::GenericAudio() {
 }
 
 GenericAudio::~GenericAudio() {
+	StopDecodeThread();
 }
 
 void GenericAudio::BGM_Play(const std::string& file, int volume, int pitch, int fadein) {
-	bool bgm_set = false;
-	for (unsigned i = 0; i < nr_of_bgm_channels; i++) {
-		BGM_Channels[i].stopped = true; //Stop all running background music
-		if (!BGM_Channels[i].decoder && !bgm_set) {
-			//If there is an unused bgm channel
-			bgm_set = true;
-			LockMutex();
-			BGM_PlayedOnceIndicator = false;
-			UnlockMutex();
-			PlayOnChannel(BGM_Channels[i], file, volume, pitch, fadein);
-		}
-	}
+	bgm_playing = true;
+	bgm_generation = (bgm_generation + 1) & generation_mask;
+
+	Command cmd;
+	cmd.type = Command::Type::BgmPlay;
+	cmd.value = bgm_generation;
+	cmd.stream = CreateBgmStream(file, volume, pitch, fadein);
+	PushCommand(std::move(cmd));
 }
 
 void GenericAudio::BGM_Pause() {
-	for (unsigned i = 0; i < nr_of_bgm_channels; i++) {
-		if (BGM_Channels[i].decoder) {
-			BGM_Channels[i].paused = true;
-		}
-	}
+	Command cmd;
+	cmd.type = Command::Type::BgmPause;
+	PushCommand(std::move(cmd));
 }
 
 void GenericAudio::BGM_Resume() {
-	for (unsigned i = 0; i < nr_of_bgm_channels; i++) {
-		if (BGM_Channels[i].decoder) {
-			BGM_Channels[i].paused = false;
-		}
-	}
+	Command cmd;
+	cmd.type = Command::Type::BgmResume;
+	PushCommand(std::move(cmd));
 }
 
 void GenericAudio::BGM_Stop() {
-	for (unsigned i = 0; i < nr_of_bgm_channels; i++) {
-		BGM_Channels[i].stopped = true; //Stop all running background music
-		LockMutex();
-		if (Muted) {
-			// If the audio is muted the audio thread doesn't perform the deletion (it isn't running)
-			// Do the cleanup on our own.
-			BGM_Channels[i].decoder.reset();
-		}
-		UnlockMutex();
-	}
+	bgm_playing = false;
+
+	Command cmd;
+	cmd.type = Command::Type::BgmStop;
+	PushCommand(std::move(cmd));
 }
 
 bool GenericAudio::BGM_PlayedOnce() const {
-	return BGM_PlayedOnceIndicator;
+	const uint64_t state = bgm_state.load(std::memory_order_acquire);
+	if ((state >> 33) != bgm_generation) {
+		// The mixer did not start the current BGM yet
+		return false;
+	}
+	return (state >> 32) & 1;
 }
 
 bool GenericAudio::BGM_IsPlaying() const {
-	for (unsigned i = 0; i < nr_of_bgm_channels; i++) {
-		if (!BGM_Channels[i].stopped) {
-			return true;
-		};
-	}
-	return false;
+	return bgm_playing;
 }
 
 unsigned GenericAudio::BGM_GetTicks() const {
-	unsigned ticks = 0;
-	LockMutex();
-	for (unsigned i = 0; i < nr_of_bgm_channels; i++) {
-		if (BGM_Channels[i].decoder) {
-			ticks = BGM_Channels[i].decoder->GetTicks();
-			break;
-		}
+	const uint64_t state = bgm_state.load(std::memory_order_acquire);
+	if ((state >> 33) != bgm_generation) {
+		return 0;
 	}
-	UnlockMutex();
-	return ticks;
+	return static_cast<unsigned>(state & 0xFFFFFFFF);
 }
 
 void GenericAudio::BGM_Fade(int fade) {
-	LockMutex();
-	for (unsigned i = 0; i < nr_of_bgm_channels; i++) {
-		if (BGM_Channels[i].decoder) {
-			BGM_Channels[i].decoder->SetFade(BGM_Channels[i].decoder->GetVolume(), 0, fade);
-		}
-	}
-	UnlockMutex();
+	Command cmd;
+	cmd.type = Command::Type::BgmFade;
+	cmd.value = fade;
+	PushCommand(std::move(cmd));
 }
 
 void GenericAudio::BGM_Volume(int volume) {
-	LockMutex();
-	for (unsigned i = 0; i < nr_of_bgm_channels; i++) {
-		if (BGM_Channels[i].decoder) {
-			BGM_Channels[i].decoder->SetVolume(volume);
-		}
-	}
-	UnlockMutex();
+	Command cmd;
+	cmd.type = Command::Type::BgmVolume;
+	cmd.value = volume;
+	PushCommand(std::move(cmd));
 }
 
 void GenericAudio::BGM_Pitch(int pitch) {
-	LockMutex();
-	for (unsigned i = 0; i < nr_of_bgm_channels; i++) {
-		if (BGM_Channels[i].decoder) {
-			BGM_Channels[i].decoder->SetPitch(pitch);
-		}
-	}
-	UnlockMutex();
+	Command cmd;
+	cmd.type = Command::Type::BgmPitch;
+	cmd.value = pitch;
+	PushCommand(std::move(cmd));
 }
 
 void GenericAudio::SE_Play(std::string const &file, int volume, int pitch) {
 	if (Muted) return;
-	for (unsigned i = 0; i < nr_of_se_channels; i++) {
-		if (!SE_Channels[i].se) {
-			//If there is an unused se channel
-			PlayOnChannel(SE_Channels[i], file, volume, pitch);
-			return;
-		}
+
+	if (se_dropped.exchange(0, std::memory_order_relaxed) > 0) {
+		Output::Warning("Couldn't play SE. No free channel available");
 	}
 
-	Output::Warning("Couldn't play %s SE. No free channel available", FileFinder::GetPathInsideGamePath(file).c_str());
+	Command cmd;
+	cmd.type = Command::Type::SePlay;
+	cmd.value = volume;
+	cmd.se = CreateSe(file, pitch);
+	if (cmd.se) {
+		PushCommand(std::move(cmd));
+	}
 }
 
 void GenericAudio::SE_Stop() {
-	for (unsigned i = 0; i < nr_of_se_channels; i++) {
-		SE_Channels[i].stopped = true; //Stop all running sound effects
-	}
+	Command cmd;
+	cmd.type = Command::Type::SeStop;
+	PushCommand(std::move(cmd));
 }
 
 void GenericAudio::Update() {
 	// no-op, handled by the Decode function called through a thread
 }
 
+void GenericAudio::SetDecodeAhead(int ms) {
+	decode_ahead_ms = ms;
+}
+
 void GenericAudio::SetFormat(int frequency, AudioDecoder::Format format, int channels) {
 	output_format.frequency = frequency;
 	output_format.format = format;
 	output_format.channels = channels;
 }
 
-bool GenericAudio::PlayOnChannel(BgmChannel& chan, const std::string& file, int volume, int pitch, int fadein) {
-	chan.paused = true; // Pause channel so the audio thread doesn't work on it
-	chan.stopped = false; // Unstop channel so the audio thread doesn't delete it
-
+GenericAudio::BgmStreamRef GenericAudio::CreateBgmStream(const std::string& file, int volume, int pitch, int fadein) {
 	FILE* filehandle = FileFinder::fopenUTF8(file, "rb");
 	if (!filehandle) {
 		Output::Warning("BGM file not readable: %s", FileFinder::GetPathInsideGamePath(file).c_str());
-		return false;
+		return nullptr;
 	}
 
-	chan.decoder = AudioDecoder::Create(filehandle, file);
-	if (chan.decoder && chan.decoder->Open(filehandle)) {
-		chan.decoder->SetPitch(pitch);
-		chan.decoder->SetFormat(output_format.frequency, output_format.format, output_format.channels);
-		chan.decoder->SetFade(0, volume, fadein);
-		chan.decoder->SetLooping(true);
-		chan.paused = false; // Unpause channel -> Play it.
+	std::unique_ptr<AudioDecoder> decoder = AudioDecoder::Create(filehandle, file);
+	if (decoder && decoder->Open(filehandle)) {
+		decoder->SetPitch(pitch);
+		decoder->SetFormat(output_format.frequency, output_format.format, output_format.channels);
+		decoder->SetFade(0, volume, fadein);
+		decoder->SetLooping(true);
+
+		std::lock_guard<std::mutex> lock(decode_mutex);
+		if (decode_ahead_ms > 0 && !decode_thread.joinable()) {
+			try {
+				decode_thread = std::thread(DecodeThread);
+			} catch (const std::system_error& e) {
+				Output::Warning("Cannot start BGM decode thread (%s), decoding in the mixer", e.what());
+				decode_ahead_ms = 0;
+			}
+		}
+
+		auto stream = std::make_shared<BgmStream>(std::move(decoder), decode_ahead_ms);
+		if (stream->IsDecodedAhead()) {
+			decode_streams.push_back(stream);
+			decode_cv.notify_one();
+		}
 
-		return true;
+		return stream;
 	} else {
 		Output::Warning("Couldn't play BGM %s. Format not supported", FileFinder::GetPathInsideGamePath(file).c_str());
-		chan.decoder.reset();
+		decoder.reset();
 		fclose(filehandle);
 	}
 
-	return false;
+	return nullptr;
 }
 
-bool GenericAudio::PlayOnChannel(SeChannel& chan, const std::string& file, int volume, int pitch) {
-	chan.paused = true; // Pause channel so the audio thread doesn't work on it
-	chan.stopped = false; // Unstop channel so the audio thread doesn't delete it
-
+AudioSeRef GenericAudio::CreateSe(const std::string& file, int pitch) {
 	std::unique_ptr<AudioSeCache> cache = AudioSeCache::Create(file);
 	if (cache) {
 		cache->SetPitch(pitch);
 		cache->SetFormat(output_format.frequency, output_format.format, output_format.channels);
 
-		chan.se = cache->Decode();
-		chan.buffer_pos = 0;
-		chan.volume = volume;
-		chan.paused = false; // Unpause channel -> Play it.
-
-		return true;
+		return cache->Decode();
 	} else {
 		Output::Warning("Couldn't play SE %s. Format not supported", FileFinder::GetPathInsideGamePath(file).c_str());
 	}
 
-	return false;
+	return nullptr;
+}
+
+void GenericAudio::PushCommand(Command cmd) {
+	const unsigned write = command_write.load(std::memory_order_relaxed);
+
+	if (write - command_read.load(std::memory_order_acquire) >= command_queue_size) {
+		// Decode is not consuming the commands (e.g. no audio device or stalled).
+		// Holding the mutex guarantees that Decode is not running, execute them here.
+		LockMutex();
+		ProcessCommands();
+		UnlockMutex();
+	}
+
+	commands[write % command_queue_size] = std::move(cmd);
+	command_write.store(write + 1, std::memory_order_release);
+}
+
+void GenericAudio::ProcessCommands() {
+	unsigned read = command_read.load(std::memory_order_relaxed);
+	const unsigned write = command_write.load(std::memory_order_acquire);
+
+	for (; read != write; ++read) {
+		Command& cmd = commands[read % command_queue_size];
+
+		switch (cmd.type) {
+			case Command::Type::BgmPlay:
+				// Stop all running background music
+				for (unsigned i = 0; i < nr_of_bgm_channels; i++) {
+					ResetBgmChannel(BGM_Channels[i]);
+				}
+				BGM_Channels[0].stream = std::move(cmd.stream);
+				BGM_Channels[0].paused = false;
+				BGM_Channels[0].stopped = false;
+				mixer_bgm_generation = cmd.value;
+				mixer_bgm_played_once = false;
+				break;
+			case Command::Type::BgmPause:
+			case Command::Type::BgmResume:
+				for (unsigned i = 0; i < nr_of_bgm_channels; i++) {
+					if (BGM_Channels[i].stream) {
+						BGM_Channels[i].paused = (cmd.type == Command::Type::BgmPause);
+					}
+				}
+				break;
+			case Command::Type::BgmStop:
+				for (unsigned i = 0; i < nr_of_bgm_channels; i++) {
+					BGM_Channels[i].stopped = true;
+				}
+				break;
+			case Command::Type::BgmFade:
+				for (unsigned i = 0; i < nr_of_bgm_channels; i++) {
+					if (BGM_Channels[i].stream) {
+						AudioDecoder& decoder = BGM_Channels[i].stream->GetDecoder();
+						decoder.SetFade(decoder.GetVolume(), 0, cmd.value);
+					}
+				}
+				break;
+			case Command::Type::BgmVolume:
+				for (unsigned i = 0; i < nr_of_bgm_channels; i++) {
+					if (BGM_Channels[i].stream) {
+						BGM_Channels[i].stream->GetDecoder().SetVolume(cmd.value);
+					}
+				}
+				break;
+			case Command::Type::BgmPitch:
+				for (unsigned i = 0; i < nr_of_bgm_channels; i++) {
+					if (BGM_Channels[i].stream) {
+						BGM_Channels[i].stream->SetPitch(cmd.value);
+					}
+				}
+				break;
+			case Command::Type::SePlay: {
+				bool played = false;
+				for (unsigned i = 0; i < nr_of_se_channels; i++) {
+					SeChannel& chan = SE_Channels[i];
+					if (!chan.se) {
+						//If there is an unused se channel
+						chan.se = std::move(cmd.se);
+						chan.buffer_pos = 0;
+						chan.volume = cmd.value;
+						chan.paused = false;
+						chan.stopped = false;
+						played = true;
+						break;
+					}
+				}
+				if (!played) {
+					se_dropped.fetch_add(1, std::memory_order_relaxed);
+				}
+				break;
+			}
+			case Command::Type::SeStop:
+				for (unsigned i = 0; i < nr_of_se_channels; i++) {
+					SE_Channels[i].stopped = true; //Stop all running sound effects
+				}
+				break;
+		}
+
+		// Release the resources here and not when the game thread reuses the slot
+		cmd.stream.reset();
+		cmd.se.reset();
+	}
+
+	command_read.store(read, std::memory_order_release);
+}
+
+void GenericAudio::PublishBgmState() {
+	unsigned ticks = 0;
+	for (unsigned i = 0; i < nr_of_bgm_channels; i++) {
+		if (BGM_Channels[i].stream) {
+			ticks = BGM_Channels[i].stream->GetTicks();
+			break;
+		}
+	}
+
+	const uint64_t state = (static_cast<uint64_t>(mixer_bgm_generation) << 33)
+		| (static_cast<uint64_t>(mixer_bgm_played_once) << 32)
+		| ticks;
+	bgm_state.store(state, std::memory_order_release);
+}
+
+void GenericAudio::ResetBgmChannel(BgmChannel& chan) {
+	if (!chan.stream) {
+		return;
+	}
+
+	if (!chan.stream->IsDecodedAhead()) {
+		chan.stream.reset();
+		return;
+	}
+
+	// The decode thread keeps its reference until it sees the flag. Dropping
+	// the mixer reference first ensures the decoder is never destroyed here.
+	BgmStream* stream = chan.stream.get();
+	chan.stream.reset();
+	stream->stopped.store(true, std::memory_order_release);
+}
+
+void GenericAudio::DecodeThread() {
+	std::vector<BgmStreamRef> streams;
+	std::vector<BgmStreamRef> finished;
+
+	std::unique_lock<std::mutex> lock(decode_mutex);
+	while (!decode_quit) {
+		auto it = std::partition(decode_streams.begin(), decode_streams.end(), [](const BgmStreamRef& stream) {
+			return !stream->stopped.load(std::memory_order_acquire);
+		});
+		std::move(it, decode_streams.end(), std::back_inserter(finished));
+		decode_streams.erase(it, decode_streams.end());
+		streams = decode_streams;
+		lock.unlock();
+
+		// Decoding and freeing decoders happens without holding the lock
+		finished.clear();
+		for (auto& stream : streams) {
+			stream->Fill();
+		}
+		streams.clear();
+
+		lock.lock();
+		if (!decode_quit) {
+			decode_cv.wait_for(lock, std::chrono::milliseconds(5));
+		}
+	}
+}
+
+void GenericAudio::StopDecodeThread() {
+	{
+		std::lock_guard<std::mutex> lock(decode_mutex);
+		decode_quit = true;
+	}
+	decode_cv.notify_one();
+
+	if (decode_thread.joinable()) {
+		decode_thread.join();
+	}
+
+	decode_streams.clear();
+	decode_quit = false;
 }
 
 void GenericAudio::Decode(uint8_t* output_buffer, int buffer_length) {
+	EP_PROFILE_ZONE(Zone_AudioDecode);
+
 	bool channel_active = false;
 	float total_volume = 0;
 	int samples_per_frame = buffer_length / output_format.channels / 2;
 
 	assert(buffer_length > 0);
 
+	ProcessCommands();
+
 	if (sample_buffer.size() != (size_t)buffer_length) {
 		sample_buffer.resize(buffer_length);
 	}
@@ -263,13 +717,14 @@ void GenericAudio::Decode(uint8_t* output_buffer, int buffer_length) {
 			BgmChannel& currently_mixed_channel = BGM_Channels[i];
 			float current_master_volume = 1.0;
 
-			if (currently_mixed_channel.decoder && !currently_mixed_channel.paused) {
+			if (currently_mixed_channel.stream && !currently_mixed_channel.paused) {
 				if (currently_mixed_channel.stopped) {
-					currently_mixed_channel.decoder.reset();
+					ResetBgmChannel(currently_mixed_channel);
 				} else {
-					currently_mixed_channel.decoder->Update(1000 / 60);
-					volume = current_master_volume * (currently_mixed_channel.decoder->GetVolume() / 100.0);
-					currently_mixed_channel.decoder->GetFormat(frequency, sampleformat, channels);
+					AudioDecoder& decoder = currently_mixed_channel.stream->GetDecoder();
+					decoder.Update(1000 / 60);
+					volume = current_master_volume * (decoder.GetVolume() / 100.0);
+					currently_mixed_channel.stream->GetFormat(frequency, sampleformat, channels);
 					samplesize = AudioDecoder::GetSamplesizeForFormat(sampleformat);
 
 					total_volume += volume;
@@ -278,16 +733,16 @@ void GenericAudio::Decode(uint8_t* output_buffer, int buffer_length) {
 					unsigned bytes_to_read = (samplesize * channels * samples_per_frame);
 					bytes_to_read = (bytes_to_read < scrap_buffer_size) ? bytes_to_read : scrap_buffer_size;
 
-					read_bytes = currently_mixed_channel.decoder->Decode(scrap_buffer.data(), bytes_to_read);
+					read_bytes = currently_mixed_channel.stream->Read(scrap_buffer.data(), bytes_to_read);
 
 					if (read_bytes < 0) {
 						// An error occured when reading - the channel is faulty - discard
-						currently_mixed_channel.decoder.reset();
+						ResetBgmChannel(currently_mixed_channel);
 						continue; // skip this loop run - there is nothing to mix
 					}
 
 					if (!currently_mixed_channel.stopped) {
-						BGM_PlayedOnceIndicator = currently_mixed_channel.decoder->GetLoopCount() > 0;
+						mixer_bgm_played_once = currently_mixed_channel.stream->GetLoopCount() > 0;
 					}
 
 					channel_used = true;
@@ -341,86 +796,20 @@ void GenericAudio::Decode(uint8_t* output_buffer, int buffer_length) {
 		//--------------------------------------------------------------------------------------------------------------------//
 
 		if (channel_used) {
-			for (unsigned ii = 0; ii < (unsigned)(read_bytes / (samplesize * channels)); ii++) {
-
-				float vall = volume;
-				float valr = vall;
-
-				// Convert to floating point
-				switch (sampleformat) {
-					case AudioDecoder::Format::S8:
-						vall *= (((int8_t *) scrap_buffer.data())[ii * channels] / 128.0);
-						valr *= (((int8_t *) scrap_buffer.data())[ii * channels + 1] / 128.0);
-						break;
-					case AudioDecoder::Format::U8:
-						vall *= (((uint8_t *) scrap_buffer.data())[ii * channels] / 128.0 - 1.0);
-						valr *= (((uint8_t *) scrap_buffer.data())[ii * channels + 1] / 128.0 - 1.0);
-						break;
-					case AudioDecoder::Format::S16:
-						vall *= (((int16_t *) scrap_buffer.data())[ii * channels] / 32768.0);
-						valr *= (((int16_t *) scrap_buffer.data())[ii * channels + 1] / 32768.0);
-						break;
-					case AudioDecoder::Format::U16:
-						vall *= (((uint16_t *) scrap_buffer.data())[ii * channels] / 32768.0 - 1.0);
-						valr *= (((uint16_t *) scrap_buffer.data())[ii * channels + 1] / 32768.0 - 1.0);
-						break;
-					case AudioDecoder::Format::S32:
-						vall *= (((int32_t *) scrap_buffer.data())[ii * channels] / 2147483648.0);
-						valr *= (((int32_t *) scrap_buffer.data())[ii * channels + 1] / 2147483648.0);
-						break;
-					case AudioDecoder::Format::U32:
-						vall *= (((uint32_t *) scrap_buffer.data())[ii * channels] / 2147483648.0 - 1.0);
-						valr *= (((uint32_t *) scrap_buffer.data())[ii * channels + 1] / 2147483648.0 - 1.0);
-						break;
-					case AudioDecoder::Format::F32:
-						vall *= (((float *) scrap_buffer.data())[ii * channels]);
-						valr *= (((float *) scrap_buffer.data())[ii * channels + 1]);
-						break;
-				}
-
-				if (!channel_active) {
-					// first channel
-					mixer_buffer[ii * output_format.channels] = vall;
-					if (channels > 1) {
-						mixer_buffer[ii * output_format.channels + 1] = valr;
-					} else {
-						mixer_buffer[ii * output_format.channels + 1] = mixer_buffer[ii * output_format.channels];
-					}
-				} else {
-					mixer_buffer[ii * output_format.channels] += vall;
-					if (channels > 1) {
-						mixer_buffer[ii * output_format.channels + 1] += valr;
-					} else {
-						mixer_buffer[ii * output_format.channels + 1] = mixer_buffer[ii * output_format.channels];
-					}
-				}
-
+			const int frames = read_bytes / (samplesize * channels);
+			if (!channel_active && frames < samples_per_frame) {
+				// The first channel overwrites the mix buffer, silence the part it does not cover
+				std::fill(mixer_buffer.begin() + frames * 2, mixer_buffer.begin() + samples_per_frame * 2, 0.0f);
 			}
+			AudioKernels::Mix(mixer_buffer.data(), scrap_buffer.data(), frames, sampleformat, channels, volume, !channel_active);
 			channel_active = true;
 		}
 	}
 
-	if (channel_active) {
-		if (total_volume > 1.0) {
-			float threshold = 0.8;
-			for (unsigned i = 0; i < (unsigned)(samples_per_frame * 2); i++) {
-				float sample = mixer_buffer[i];
-				float sign = (sample < 0) ? -1.0 : 1.0;
-				sample /= sign;
-				//dynamic range compression
-				if (sample > threshold) {
-					sample_buffer[i] = sign * 32768.0 * (threshold + (1.0 - threshold) * (sample - threshold) / (total_volume - threshold));
-				} else {
-					sample_buffer[i] = sign * sample * 32768.0;
-				}
-			}
-		} else {
-			//No dynamic range compression necessary
-			for (unsigned i = 0; i < (unsigned)(samples_per_frame * 2); i++) {
-				sample_buffer[i] = mixer_buffer[i] * 32768.0;
-			}
-		}
+	PublishBgmState();
 
+	if (channel_active) {
+		AudioKernels::Clip(sample_buffer.data(), mixer_buffer.data(), samples_per_frame * 2, total_volume);
 		memcpy(output_buffer, sample_buffer.data(), buffer_length);
 	} else {
 		memset(output_buffer, '\0', buffer_length);
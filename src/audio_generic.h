@@ -18,6 +18,11 @@
 #ifndef EP_AUDIO_GENERIC_H
 #define EP_AUDIO_GENERIC_H
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include "audio.h"
 #include "audio_decoder.h"
 #include "audio_secache.h"
@@ -35,6 +40,16 @@
  * 4. Implement LockMutex and UnlockMutex. Locking and Unlocking when
  *    calling Decode must be done manually.
  * 5. Implement update function (optional)
+ *
+ * The game thread does not access the channels. Requests are passed to the
+ * Decode function through a lock-free single producer, single consumer
+ * command queue and the BGM state is published through atomics, so the game
+ * thread never waits for a running Decode. The mutex is only taken when the
+ * queue is full because Decode is not called (e.g. no audio device).
+ *
+ * BGM is decoded ahead by a separate thread into a ring buffer per stream
+ * (see Player::bgm_buffer_ms), Decode only mixes the buffered data. This
+ * keeps slow decoders (e.g. MP3 or MIDI) out of the audio callback.
  */
 struct GenericAudio : public AudioInterface {
 public:
@@ -57,14 +72,26 @@ public:
 
 	void SetFormat(int frequency, AudioDecoder::Format format, int channels);
 
+	/**
+	 * Sets how many milliseconds of BGM the decode thread keeps decoded.
+	 * Must be called before the first BGM is played.
+	 * Defaults to Player::bgm_buffer_ms.
+	 *
+	 * @param ms milliseconds, 0 decodes in the mixer without a thread
+	 */
+	void SetDecodeAhead(int ms);
+
 	virtual void LockMutex() const = 0;
 	virtual void UnlockMutex() const = 0;
 
 	void Decode(uint8_t* output_buffer, int buffer_length);
 
 private:
+	class BgmStream;
+	using BgmStreamRef = std::shared_ptr<BgmStream>;
+
 	struct BgmChannel {
-		std::unique_ptr<AudioDecoder> decoder;
+		BgmStreamRef stream;
 		bool paused;
 		bool stopped;
 	};
@@ -83,17 +110,83 @@ private:
 	};
 	Format output_format = {0};
 
-	bool PlayOnChannel(BgmChannel& chan,std::string const& file, int volume, int pitch, int fadein);
-	bool PlayOnChannel(SeChannel& chan,std::string const& file, int volume, int pitch);
+	/** Request from the game thread, executed by Decode */
+	struct Command {
+		enum class Type {
+			BgmPlay,
+			BgmPause,
+			BgmResume,
+			BgmStop,
+			BgmFade,
+			BgmVolume,
+			BgmPitch,
+			SePlay,
+			SeStop
+		};
+		Type type = Type::BgmStop;
+		/** Volume, pitch, fade time or BGM generation depending on the type */
+		int value = 0;
+		BgmStreamRef stream;
+		AudioSeRef se;
+	};
+
+	BgmStreamRef CreateBgmStream(std::string const& file, int volume, int pitch, int fadein);
+	AudioSeRef CreateSe(std::string const& file, int pitch);
+
+	/** Game thread: Queues a command for the next Decode call. */
+	void PushCommand(Command cmd);
+	/** Mixer: Executes all queued commands. */
+	void ProcessCommands();
+	/** Mixer: Makes the BGM ticks and loop state visible to the game thread. */
+	void PublishBgmState();
+	/** Mixer: Stops a BGM channel and hands its stream back to the decode thread. */
+	static void ResetBgmChannel(BgmChannel& chan);
+
+	/** Decode thread: Fills the ring buffers of all registered streams. */
+	static void DecodeThread();
+	/** Stops the decode thread and releases all streams. */
+	static void StopDecodeThread();
 
 	static const unsigned nr_of_se_channels=31;
 	static const unsigned nr_of_bgm_channels=2;
 
 	static BgmChannel BGM_Channels[nr_of_bgm_channels];
 	static SeChannel SE_Channels[nr_of_se_channels];
-	static bool BGM_PlayedOnceIndicator;
 	static bool Muted;
 
+	static const unsigned command_queue_size = 64;
+	static std::array<Command, command_queue_size> commands;
+	/** Number of commands ever read by the mixer, written by the mixer */
+	static std::atomic<unsigned> command_read;
+	/** Number of commands ever queued, written by the game thread */
+	static std::atomic<unsigned> command_write;
+
+	// Game thread state
+	static bool bgm_playing;
+	static uint32_t bgm_generation;
+
+	// Mixer state
+	static uint32_t mixer_bgm_generation;
+	static bool mixer_bgm_played_once;
+
+	/**
+	 * BGM state published by the mixer: Generation of the BGM_Play call
+	 * (bits 33-63), played once flag (bit 32) and ticks (bits 0-31).
+	 */
+	static std::atomic<uint64_t> bgm_state;
+	/** Number of SE the mixer dropped because no channel was free */
+	static std::atomic<unsigned> se_dropped;
+
+	/** Milliseconds of BGM decoded ahead, 0 when decoding in the mixer */
+	static int decode_ahead_ms;
+	static std::thread decode_thread;
+	/** Guards decode_streams and decode_quit */
+	static std::mutex decode_mutex;
+	static std::condition_variable decode_cv;
+	/** Streams filled by the decode thread */
+	static std::vector<BgmStreamRef> decode_streams;
+	static bool decode_quit;
+
 	static std::vector<int16_t> sample_buffer;
 	static std::vector<uint8_t> scrap_buffer;
 	static unsigned scrap_buffer_size;
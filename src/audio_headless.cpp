@@ -0,0 +1,55 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "system.h"
+
+#ifdef SUPPORT_AUDIO
+
+#include "audio_headless.h"
+#include "graphics.h"
+
+namespace {
+	constexpr int AUDIO_SAMPLERATE = 44100;
+}
+
+HeadlessAudio::HeadlessAudio() :
+	GenericAudio() {
+	SetFormat(AUDIO_SAMPLERATE, AudioDecoder::Format::S16, 2);
+	// Decode synchronously, the output must not depend on thread timing
+	SetDecodeAhead(0);
+
+	buffer.resize(AUDIO_SAMPLERATE / Graphics::GetDefaultFps() * 2 * 2);
+}
+
+void HeadlessAudio::Update() {
+	// No audio thread, Decode runs synchronously once per frame
+	Decode(buffer.data(), buffer.size());
+}
+
+void HeadlessAudio::LockMutex() const {
+	// no-op, everything runs on the game thread
+}
+
+void HeadlessAudio::UnlockMutex() const {
+	// no-op, everything runs on the game thread
+}
+
+const std::vector<uint8_t>& HeadlessAudio::GetSamples() const {
+	return buffer;
+}
+
+#endif
@@ -0,0 +1,52 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_AUDIO_HEADLESS_H
+#define EP_AUDIO_HEADLESS_H
+
+#include "system.h"
+
+#ifdef SUPPORT_AUDIO
+
+#include <vector>
+#include "audio_generic.h"
+
+/**
+ * Audio sink for the headless backend.
+ * There is no audio device: Update mixes one frame of samples into an
+ * in-memory buffer on the game thread so the decoding cost is still measured.
+ */
+class HeadlessAudio : public GenericAudio {
+public:
+	HeadlessAudio();
+
+	void Update() override;
+
+	void LockMutex() const override;
+	void UnlockMutex() const override;
+
+	/**
+	 * @return samples mixed by the last Update call (S16, stereo)
+	 */
+	const std::vector<uint8_t>& GetSamples() const;
+
+private:
+	std::vector<uint8_t> buffer;
+};
+
+#endif
+#endif
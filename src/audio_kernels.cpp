@@ -0,0 +1,410 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include "audio_kernels.h"
+
+// The vectorized kernels use the vector extensions of GCC and Clang, the
+// compiler emits SSE2 or NEON instructions for them.
+// Samples narrower than 32 bit are unpacked assuming little endian.
+#if defined(__GNUC__) && (defined(__clang__) || __GNUC__ >= 9) && \
+	(defined(__SSE2__) || defined(__ARM_NEON) || defined(__ARM_NEON__)) && \
+	__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#  define EP_AUDIO_KERNELS_VECTOR
+#  define EP_ALWAYS_INLINE inline __attribute__((always_inline))
+#endif
+
+namespace {
+	/**
+	 * Conversion of a sample to float as sample * scale + offset.
+	 * Volume is already multiplied into both.
+	 */
+	struct Conversion {
+		float scale;
+		float offset;
+	};
+
+	Conversion MakeConversion(AudioDecoder::Format format, float volume) {
+		float scale = 1.0f;
+		float offset = 0.0f;
+
+		switch (format) {
+			case AudioDecoder::Format::S8:
+				scale = 1.0f / 128.0f;
+				break;
+			case AudioDecoder::Format::U8:
+				scale = 1.0f / 128.0f;
+				offset = -1.0f;
+				break;
+			case AudioDecoder::Format::S16:
+				scale = 1.0f / 32768.0f;
+				break;
+			case AudioDecoder::Format::U16:
+				scale = 1.0f / 32768.0f;
+				offset = -1.0f;
+				break;
+			case AudioDecoder::Format::S32:
+				scale = 1.0f / 2147483648.0f;
+				break;
+			case AudioDecoder::Format::U32:
+				scale = 1.0f / 2147483648.0f;
+				offset = -1.0f;
+				break;
+			case AudioDecoder::Format::F32:
+				break;
+		}
+
+		return { scale * volume, offset * volume };
+	}
+
+	/** Compression parameters of Clip */
+	struct ClipSetup {
+		/** Samples above are compressed */
+		float limit;
+		/** Slope of the compression */
+		float slope;
+	};
+
+	ClipSetup MakeClipSetup(float total_volume) {
+		using AudioKernels::compress_threshold;
+
+		if (total_volume <= 1.0f) {
+			// No dynamic range compression necessary
+			return { std::numeric_limits<float>::max(), 1.0f };
+		}
+		return { compress_threshold, (1.0f - compress_threshold) / (total_volume - compress_threshold) };
+	}
+
+	template <typename T>
+	void MixScalar(float* mix, const T* samples, int frames, int channels, const Conversion& conv, bool overwrite) {
+		if (channels == 1) {
+			for (int i = 0; i < frames; ++i) {
+				const float v = static_cast<float>(samples[i]) * conv.scale + conv.offset;
+				if (overwrite) {
+					mix[i * 2] = v;
+					mix[i * 2 + 1] = v;
+				} else {
+					mix[i * 2] += v;
+					mix[i * 2 + 1] += v;
+				}
+			}
+			return;
+		}
+
+		if (channels == 2) {
+			const int count = frames * 2;
+			for (int i = 0; i < count; ++i) {
+				const float v = static_cast<float>(samples[i]) * conv.scale + conv.offset;
+				mix[i] = overwrite ? v : mix[i] + v;
+			}
+			return;
+		}
+
+		// More channels, only the first two are mixed
+		for (int i = 0; i < frames; ++i) {
+			for (int c = 0; c < 2; ++c) {
+				const float v = static_cast<float>(samples[i * channels + c]) * conv.scale + conv.offset;
+				mix[i * 2 + c] = overwrite ? v : mix[i * 2 + c] + v;
+			}
+		}
+	}
+
+	inline int16_t ClipSample(float sample, const ClipSetup& setup) {
+		using AudioKernels::compress_threshold;
+
+		float mag = std::fabs(sample);
+		if (mag > setup.limit) {
+			//dynamic range compression
+			mag = compress_threshold + (mag - compress_threshold) * setup.slope;
+		}
+		mag *= 32768.0f;
+
+		float v = sample < 0.0f ? -mag : mag;
+		v = v > 32767.0f ? 32767.0f : v < -32768.0f ? -32768.0f : v;
+		return static_cast<int16_t>(v);
+	}
+
+	void ClipScalar(int16_t* output, const float* mix, int count, const ClipSetup& setup) {
+		for (int i = 0; i < count; ++i) {
+			output[i] = ClipSample(mix[i], setup);
+		}
+	}
+
+#ifdef EP_AUDIO_KERNELS_VECTOR
+	typedef float Float4 __attribute__((vector_size(16)));
+	typedef int32_t Int4 __attribute__((vector_size(16)));
+	typedef uint32_t UInt4 __attribute__((vector_size(16)));
+	typedef int16_t Short4 __attribute__((vector_size(8)));
+
+	// Comparisons return -1 (all bits set) for true lanes
+#define EP_SELECT(mask, a, b) ((Float4)(((Int4)(a) & (mask)) | ((Int4)(b) & ~(mask))))
+
+	/**
+	 * Loads 16 bytes of samples and converts them to floats in sample order.
+	 * A direct conversion of 8 and 16 bit vectors is split into single
+	 * samples on SSE2, these are unpacked with shifts instead.
+	 */
+	template <typename T>
+	struct Loader {
+		static constexpr int count = 4;
+
+		static EP_ALWAYS_INLINE void Load(const T* samples, Float4* out) {
+			typedef T V __attribute__((vector_size(16)));
+
+			V v;
+			memcpy(&v, samples, sizeof(v));
+			out[0] = __builtin_convertvector(v, Float4);
+		}
+	};
+
+	EP_ALWAYS_INLINE void Interleave2(Int4 a, Int4 b, Float4* out) {
+		const Float4 fa = __builtin_convertvector(a, Float4);
+		const Float4 fb = __builtin_convertvector(b, Float4);
+		out[0] = (Float4){ fa[0], fb[0], fa[1], fb[1] };
+		out[1] = (Float4){ fa[2], fb[2], fa[3], fb[3] };
+	}
+
+	EP_ALWAYS_INLINE void Interleave4(Int4 a, Int4 b, Int4 c, Int4 d, Float4* out) {
+		const Float4 fa = __builtin_convertvector(a, Float4);
+		const Float4 fb = __builtin_convertvector(b, Float4);
+		const Float4 fc = __builtin_convertvector(c, Float4);
+		const Float4 fd = __builtin_convertvector(d, Float4);
+		for (int i = 0; i < 4; ++i) {
+			out[i] = (Float4){ fa[i], fb[i], fc[i], fd[i] };
+		}
+	}
+
+	template <>
+	struct Loader<int8_t> {
+		static constexpr int count = 16;
+
+		static EP_ALWAYS_INLINE void Load(const int8_t* samples, Float4* out) {
+			Int4 v;
+			memcpy(&v, samples, sizeof(v));
+			Interleave4((v << 24) >> 24, (v << 16) >> 24, (v << 8) >> 24, v >> 24, out);
+		}
+	};
+
+	template <>
+	struct Loader<uint8_t> {
+		static constexpr int count = 16;
+
+		static EP_ALWAYS_INLINE void Load(const uint8_t* samples, Float4* out) {
+			UInt4 v;
+			memcpy(&v, samples, sizeof(v));
+			Interleave4((Int4)(v & 0xFF), (Int4)((v >> 8) & 0xFF), (Int4)((v >> 16) & 0xFF), (Int4)(v >> 24), out);
+		}
+	};
+
+	template <>
+	struct Loader<int16_t> {
+		static constexpr int count = 8;
+
+		static EP_ALWAYS_INLINE void Load(const int16_t* samples, Float4* out) {
+			Int4 v;
+			memcpy(&v, samples, sizeof(v));
+			Interleave2((v << 16) >> 16, v >> 16, out);
+		}
+	};
+
+	template <>
+	struct Loader<uint16_t> {
+		static constexpr int count = 8;
+
+		static EP_ALWAYS_INLINE void Load(const uint16_t* samples, Float4* out) {
+			UInt4 v;
+			memcpy(&v, samples, sizeof(v));
+			Interleave2((Int4)(v & 0xFFFF), (Int4)(v >> 16), out);
+		}
+	};
+
+	EP_ALWAYS_INLINE void Store4(float* mix, Float4 v, bool overwrite) {
+		if (!overwrite) {
+			Float4 m;
+			memcpy(&m, mix, sizeof(m));
+			v += m;
+		}
+		memcpy(mix, &v, sizeof(v));
+	}
+
+	template <typename T>
+	void MixVector128(float* mix, const T* samples, int frames, int channels, const Conversion& conv, bool overwrite) {
+		// Samples are processed in blocks of 16 bytes, the remainder by the scalar code
+		constexpr int block = Loader<T>::count;
+		Float4 v[block / 4];
+
+		int i = 0;
+		if (channels == 1) {
+			for (; i + block <= frames; i += block) {
+				Loader<T>::Load(samples + i, v);
+				for (int j = 0; j < block / 4; ++j) {
+					const Float4 s = v[j] * conv.scale + conv.offset;
+					Store4(mix + (i + j * 4) * 2, (Float4){ s[0], s[0], s[1], s[1] }, overwrite);
+					Store4(mix + (i + j * 4) * 2 + 4, (Float4){ s[2], s[2], s[3], s[3] }, overwrite);
+				}
+			}
+			MixScalar(mix + i * 2, samples + i, frames - i, channels, conv, overwrite);
+			return;
+		}
+
+		const int count = frames * 2;
+		for (; i + block <= count; i += block) {
+			Loader<T>::Load(samples + i, v);
+			for (int j = 0; j < block / 4; ++j) {
+				Store4(mix + i + j * 4, v[j] * conv.scale + conv.offset, overwrite);
+			}
+		}
+		MixScalar(mix + i, samples + i, (count - i) / 2, channels, conv, overwrite);
+	}
+
+	void ClipVector128(int16_t* output, const float* mix, int count, const ClipSetup& setup) {
+		using AudioKernels::compress_threshold;
+
+		const Int4 abs_mask = { 0x7FFFFFFF, 0x7FFFFFFF, 0x7FFFFFFF, 0x7FFFFFFF };
+		const Float4 max = { 32767.0f, 32767.0f, 32767.0f, 32767.0f };
+		const Float4 min = { -32768.0f, -32768.0f, -32768.0f, -32768.0f };
+
+		int i = 0;
+		for (; i + 4 <= count; i += 4) {
+			Float4 s;
+			memcpy(&s, mix + i, sizeof(s));
+
+			const Int4 negative = s < 0.0f;
+			Float4 mag = (Float4)((Int4)s & abs_mask);
+
+			const Int4 compress = mag > setup.limit;
+			mag = EP_SELECT(compress, compress_threshold + (mag - compress_threshold) * setup.slope, mag);
+			mag *= 32768.0f;
+
+			Float4 v = EP_SELECT(negative, -mag, mag);
+			v = EP_SELECT(v > max, max, v);
+			v = EP_SELECT(v < min, min, v);
+
+			const Short4 out = __builtin_convertvector(__builtin_convertvector(v, Int4), Short4);
+			memcpy(output + i, &out, sizeof(out));
+		}
+
+		ClipScalar(output + i, mix + i, count - i, setup);
+	}
+
+#undef EP_SELECT
+#endif
+
+	AudioKernels::Implementation Resolve(AudioKernels::Implementation impl) {
+		if (impl != AudioKernels::Impl_Best) {
+			return AudioKernels::IsSupported(impl) ? impl : AudioKernels::Impl_Scalar;
+		}
+
+		return AudioKernels::IsSupported(AudioKernels::Impl_Vector128) ?
+			AudioKernels::Impl_Vector128 : AudioKernels::Impl_Scalar;
+	}
+
+	template <typename T>
+	void MixFormat(float* mix, const uint8_t* samples, int frames, int channels, const Conversion& conv,
+			bool overwrite, AudioKernels::Implementation impl) {
+		const T* typed_samples = reinterpret_cast<const T*>(samples);
+
+#ifdef EP_AUDIO_KERNELS_VECTOR
+		if (impl == AudioKernels::Impl_Vector128 && channels <= 2) {
+			MixVector128(mix, typed_samples, frames, channels, conv, overwrite);
+			return;
+		}
+#else
+		(void)impl;
+#endif
+		MixScalar(mix, typed_samples, frames, channels, conv, overwrite);
+	}
+}
+
+bool AudioKernels::IsSupported(Implementation impl) {
+	switch (impl) {
+		case Impl_Scalar:
+		case Impl_Best:
+			return true;
+		case Impl_Vector128:
+#ifdef EP_AUDIO_KERNELS_VECTOR
+			return true;
+#else
+			return false;
+#endif
+	}
+	return false;
+}
+
+const char* AudioKernels::GetName(Implementation impl) {
+	switch (Resolve(impl)) {
+		case Impl_Scalar:
+			return "scalar";
+		case Impl_Vector128:
+#if defined(__SSE2__)
+			return "SSE2";
+#else
+			return "NEON";
+#endif
+		case Impl_Best:
+			break;
+	}
+	return "";
+}
+
+void AudioKernels::Mix(float* mix, const uint8_t* samples, int frames, AudioDecoder::Format format, int channels,
+		float volume, bool overwrite, Implementation impl) {
+	const Conversion conv = MakeConversion(format, volume);
+	impl = Resolve(impl);
+
+	switch (format) {
+		case AudioDecoder::Format::S8:
+			MixFormat<int8_t>(mix, samples, frames, channels, conv, overwrite, impl);
+			return;
+		case AudioDecoder::Format::U8:
+			MixFormat<uint8_t>(mix, samples, frames, channels, conv, overwrite, impl);
+			return;
+		case AudioDecoder::Format::S16:
+			MixFormat<int16_t>(mix, samples, frames, channels, conv, overwrite, impl);
+			return;
+		case AudioDecoder::Format::U16:
+			MixFormat<uint16_t>(mix, samples, frames, channels, conv, overwrite, impl);
+			return;
+		case AudioDecoder::Format::S32:
+			MixFormat<int32_t>(mix, samples, frames, channels, conv, overwrite, impl);
+			return;
+		case AudioDecoder::Format::U32:
+			MixFormat<uint32_t>(mix, samples, frames, channels, conv, overwrite, impl);
+			return;
+		case AudioDecoder::Format::F32:
+			MixFormat<float>(mix, samples, frames, channels, conv, overwrite, impl);
+			return;
+	}
+}
+
+void AudioKernels::Clip(int16_t* output, const float* mix, int count, float total_volume, Implementation impl) {
+	const ClipSetup setup = MakeClipSetup(total_volume);
+
+	switch (Resolve(impl)) {
+#ifdef EP_AUDIO_KERNELS_VECTOR
+		case Impl_Vector128:
+			ClipVector128(output, mix, count, setup);
+			return;
+#endif
+		default:
+			ClipScalar(output, mix, count, setup);
+			return;
+	}
+}
@@ -0,0 +1,86 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_AUDIO_KERNELS_H
+#define EP_AUDIO_KERNELS_H
+
+// Headers
+#include <cstdint>
+#include "audio_decoder.h"
+
+/**
+ * AudioKernels namespace.
+ * Sample conversion and mixing of GenericAudio working on blocks of
+ * interleaved stereo float samples.
+ * The sample format is resolved once per block and not per sample.
+ */
+namespace AudioKernels {
+	enum Implementation {
+		/** Plain C++, one sample at a time */
+		Impl_Scalar,
+		/** 128 bit vectors (SSE2 or NEON) */
+		Impl_Vector128,
+		/** Fastest implementation supported by the CPU */
+		Impl_Best
+	};
+
+	/** Volume above which the mixed samples are compressed */
+	constexpr float compress_threshold = 0.8f;
+
+	/**
+	 * @param impl implementation
+	 * @return whether the implementation is available on this CPU
+	 */
+	bool IsSupported(Implementation impl);
+
+	/**
+	 * @param impl implementation, Impl_Best is resolved
+	 * @return name of the implementation
+	 */
+	const char* GetName(Implementation impl);
+
+	/**
+	 * Converts samples to float, scales them by the volume and adds them
+	 * to the stereo mix buffer. Mono samples are added to both channels.
+	 *
+	 * @param mix stereo mix buffer, holds 2 * frames samples
+	 * @param samples samples to add
+	 * @param frames number of frames in samples
+	 * @param format format of samples
+	 * @param channels channels of samples, only the first two are mixed
+	 * @param volume volume (1.0 is full volume)
+	 * @param overwrite whether mix is overwritten instead of added to
+	 * @param impl implementation to use
+	 */
+	void Mix(float* mix, const uint8_t* samples, int frames, AudioDecoder::Format format, int channels,
+		float volume, bool overwrite, Implementation impl = Impl_Best);
+
+	/**
+	 * Converts the mix buffer to signed 16 bit samples.
+	 * When the total volume of the mixed channels is above 1.0 samples above
+	 * compress_threshold are compressed to fit into the sample range.
+	 *
+	 * @param output output samples
+	 * @param mix mix buffer
+	 * @param count number of samples
+	 * @param total_volume sum of the volumes of all mixed channels
+	 * @param impl implementation to use
+	 */
+	void Clip(int16_t* output, const float* mix, int count, float total_volume, Implementation impl = Impl_Best);
+}
+
+#endif
@@ -122,6 +122,18 @@ void Background::SetTone(Tone tone) {
 		tone_effect = tone;
 	}
 }
+bool Background::GetDrawState(DrawState& state) {
+	if (!visible)
+		return true;
+
+	state.rect = DisplayUi->GetDisplaySurface()->GetRect();
+	state.Add(bg_bitmap).Add(fg_bitmap)
+		.Add(Scale(bg_x)).Add(Scale(bg_y)).Add(Scale(fg_x)).Add(Scale(fg_y))
+		.Add(Main_Data::game_data.screen.shake_position)
+		.Add(tone_effect);
+	return true;
+}
+
 void Background::Update(int& rate, int& value) {
 	int step =
 		(rate > 0) ? 2 << rate :
@@ -32,6 +32,7 @@ public:
 	~Background() override;
 
 	void Draw() override;
+	bool GetDrawState(DrawState& state) override;
 	void Update();
 	Tone GetTone() const;
 	void SetTone(Tone tone);
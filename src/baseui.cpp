@@ -31,6 +31,8 @@
 #  include "psp2_ui.h"
 #elif defined(__SWITCH__)
 #  include "switch_ui.h"
+#elif defined(USE_HEADLESS)
+#  include "headless_ui.h"
 #endif
 
 std::shared_ptr<BaseUi> DisplayUi;
@@ -52,6 +54,9 @@ std::shared_ptr<BaseUi> BaseUi::CreateUi(long width, long height, bool fs_flag,
 	return std::make_shared<Psp2Ui>(width, height);
 #elif defined(__SWITCH__)
 	return std::make_shared<NxUi>(width, height);
+#elif defined(USE_HEADLESS)
+	(void) fs_flag;
+	return std::make_shared<HeadlessUi>(width, height);
 #else
 #  error cannot create UI
 #endif
@@ -117,3 +122,19 @@ void BaseUi::CleanDisplay() {
 void BaseUi::AddBackground() {
 	main_surface->Fill(back_color);
 }
+
+void BaseUi::SetDisplayDamage(const std::vector<Rect>& rects) {
+	display_damage = rects;
+	display_damage_valid = true;
+}
+
+bool BaseUi::TakeDisplayDamage(std::vector<Rect>& rects) {
+	if (!display_damage_valid) {
+		return false;
+	}
+
+	rects.swap(display_damage);
+	display_damage.clear();
+	display_damage_valid = false;
+	return true;
+}
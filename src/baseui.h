@@ -21,6 +21,7 @@
 // Headers
 #include <string>
 #include <bitset>
+#include <vector>
 
 #include "system.h"
 #include "color.h"
@@ -95,6 +96,15 @@ public:
 	 */
 	virtual void UpdateDisplay() = 0;
 
+	/**
+	 * Sets the areas of the display surface which changed since the last
+	 * UpdateDisplay. Only applies to the next UpdateDisplay, without a call
+	 * the whole display surface is considered changed.
+	 *
+	 * @param rects changed areas, empty when nothing changed.
+	 */
+	void SetDisplayDamage(const std::vector<Rect>& rects);
+
 	/**
 	 * Gets a copy of the display surface.
 	 *
@@ -232,6 +242,14 @@ protected:
 		uint32_t flags;
 	};
 
+	/**
+	 * Fetches the areas passed to SetDisplayDamage and resets them.
+	 *
+	 * @param rects receives the changed areas.
+	 * @return false when the whole display surface must be updated.
+	 */
+	bool TakeDisplayDamage(std::vector<Rect>& rects);
+
 	/** Current display mode. */
 	DisplayMode current_display_mode;
 
@@ -254,6 +272,10 @@ protected:
 
 	/** Color for display background. */
 	Color back_color;
+
+	/** Areas changed since the last UpdateDisplay, see SetDisplayDamage. */
+	std::vector<Rect> display_damage;
+	bool display_damage_valid = false;
 };
 
 /** Global DisplayUi variable. */
@@ -58,6 +58,10 @@ DrawableType BattleAnimation::GetType() const {
 	return TypeDefault;
 }
 
+bool BattleAnimation::GetDrawState(DrawState&) {
+	return false;
+}
+
 void BattleAnimation::Update() {
 	if (frame_update) {
 		frame++;
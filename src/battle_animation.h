@@ -38,6 +38,9 @@ public:
 
 	DrawableType GetType() const override;
 
+	// Animations can draw several times per frame, damage is not tracked
+	bool GetDrawState(DrawState& state) override;
+
 	void Update();
 	int GetFrame() const;
 	int GetFrames() const;
@@ -0,0 +1,143 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include <algorithm>
+#include <array>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "benchmark.h"
+
+namespace {
+	using clock = std::chrono::steady_clock;
+
+	// Last entry is the whole frame
+	constexpr int column_count = Benchmark::Section_Count + 1;
+	using FrameTimes = std::array<double, column_count>;
+
+	const char* const column_names[column_count] = {
+		"Scene::Update",
+		"Graphics::LocalDraw",
+		"Graphics::GlobalDraw",
+		"UpdateDisplay",
+		"Frame"
+	};
+
+	bool active = false;
+	bool in_frame = false;
+	int max_frames = 0;
+
+	clock::time_point frame_start;
+	FrameTimes current;
+	std::vector<FrameTimes> frames;
+
+	double ToMicroseconds(clock::duration d) {
+		return std::chrono::duration<double, std::micro>(d).count();
+	}
+
+	// Nearest rank percentile of a sorted list
+	double Percentile(const std::vector<double>& sorted, int p) {
+		size_t rank = (sorted.size() * p + 99) / 100;
+		return sorted[std::max<size_t>(rank, 1) - 1];
+	}
+}
+
+void Benchmark::Init(int frames_to_record) {
+	active = true;
+	in_frame = false;
+	max_frames = frames_to_record;
+	frames.clear();
+	frames.reserve(max_frames > 0 ? max_frames : 60 * 60);
+}
+
+bool Benchmark::IsActive() {
+	return active;
+}
+
+void Benchmark::BeginFrame() {
+	if (!active) {
+		return;
+	}
+
+	current.fill(0.0);
+	in_frame = true;
+	frame_start = clock::now();
+}
+
+bool Benchmark::EndFrame() {
+	if (!active || !in_frame) {
+		return false;
+	}
+
+	current[Section_Count] = ToMicroseconds(clock::now() - frame_start);
+	frames.push_back(current);
+	in_frame = false;
+
+	return max_frames > 0 && static_cast<int>(frames.size()) >= max_frames;
+}
+
+void Benchmark::PrintResults() {
+	if (!active) {
+		return;
+	}
+
+	std::cout << "Benchmark: " << frames.size() << " frames (times in microseconds)" << std::endl;
+
+	if (frames.empty()) {
+		return;
+	}
+
+	std::cout << std::left << std::setw(22) << "" << std::right;
+	for (const char* name : { "mean", "p50", "p95", "p99", "max" }) {
+		std::cout << std::setw(11) << name;
+	}
+	std::cout << std::endl;
+
+	std::cout << std::fixed << std::setprecision(1);
+
+	std::vector<double> column(frames.size());
+	for (int i = 0; i < column_count; ++i) {
+		double sum = 0.0;
+		for (size_t j = 0; j < frames.size(); ++j) {
+			column[j] = frames[j][i];
+			sum += column[j];
+		}
+		std::sort(column.begin(), column.end());
+
+		std::cout << std::left << std::setw(22) << column_names[i] << std::right
+			<< std::setw(11) << sum / column.size()
+			<< std::setw(11) << Percentile(column, 50)
+			<< std::setw(11) << Percentile(column, 95)
+			<< std::setw(11) << Percentile(column, 99)
+			<< std::setw(11) << column.back() << std::endl;
+	}
+}
+
+Benchmark::ScopedTimer::ScopedTimer(Section section) :
+	section(section), active(::active && in_frame) {
+	if (active) {
+		start = clock::now();
+	}
+}
+
+Benchmark::ScopedTimer::~ScopedTimer() {
+	if (active) {
+		current[section] += ToMicroseconds(clock::now() - start);
+	}
+}
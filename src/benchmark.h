@@ -0,0 +1,87 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_BENCHMARK_H
+#define EP_BENCHMARK_H
+
+// Headers
+#include <chrono>
+
+/**
+ * Benchmark namespace.
+ * Records per-frame timings of the main loop for --benchmark and reports
+ * percentiles on exit.
+ */
+namespace Benchmark {
+	/** Parts of a frame that are measured individually */
+	enum Section {
+		Section_SceneUpdate,
+		Section_LocalDraw,
+		Section_GlobalDraw,
+		Section_UpdateDisplay,
+		Section_Count
+	};
+
+	/**
+	 * Enables recording.
+	 *
+	 * @param frames amount of frames to record, 0 records until the player exits
+	 */
+	void Init(int frames);
+
+	/**
+	 * @return whether a benchmark is running
+	 */
+	bool IsActive();
+
+	/**
+	 * Marks the start of a frame.
+	 */
+	void BeginFrame();
+
+	/**
+	 * Marks the end of a frame and stores the timings of it.
+	 *
+	 * @return true when the requested amount of frames was recorded
+	 */
+	bool EndFrame();
+
+	/**
+	 * Prints the percentiles of all recorded frames on stdout.
+	 */
+	void PrintResults();
+
+	/**
+	 * Adds the time between construction and destruction to a section of
+	 * the current frame. Does nothing when no benchmark is running.
+	 */
+	class ScopedTimer {
+	public:
+		explicit ScopedTimer(Section section);
+		~ScopedTimer();
+
+		ScopedTimer(const ScopedTimer&) = delete;
+		ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+	private:
+		Section section;
+		bool active;
+		std::chrono::steady_clock::time_point start;
+	};
+}
+
+#endif
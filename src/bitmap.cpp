@@ -20,6 +20,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <algorithm>
+#include <atomic>
 #include <iostream>
 
 #include "utils.h"
@@ -36,10 +37,15 @@
 #include "font.h"
 #include "output.h"
 #include "util_macro.h"
-#include "bitmap_hslrgb.h"
+#include "bitmap_kernels.h"
 
 const Opacity Opacity::opaque;
 
+namespace {
+	// Shared by all bitmaps to make revisions unique
+	std::atomic<uint64_t> next_revision(1);
+}
+
 BitmapRef Bitmap::Create(int width, int height, const Color& color) {
 	BitmapRef surface = Bitmap::Create(width, height, true);
 	surface->Fill(color);
@@ -312,16 +318,7 @@ void Bitmap::HueChangeBlit(int x, int y, Bitmap const& src, Rect const& src_rect
 	Bitmap bmp(reinterpret_cast<void*>(&pixels.front()), src_rect.width, src_rect.height, src_rect.width * 4, format);
 	bmp.Blit(0, 0, src, src_rect, Opacity::opaque);
 
-	for (std::vector<uint32_t>::iterator p = pixels.begin(); p != pixels.end(); ++p) {
-		uint32_t pixel = *p;
-		uint8_t r = (pixel>>24) & 0xFF;
-		uint8_t g = (pixel>>16) & 0xFF;
-		uint8_t b = (pixel>> 8) & 0xFF;
-		uint8_t a = pixel & 0xFF;
-		if (a > 0)
-			RGB_adjust_HSL(r, g, b, hue);
-		*p = ((uint32_t) r << 24) | ((uint32_t) g << 16) | ((uint32_t) b << 8) | (uint32_t) a;
-	}
+	BitmapKernels::HueChangeRow(pixels.data(), pixels.size(), hue);
 
 	Blit(dst_rect.x, dst_rect.y, bmp, bmp.GetRect(), Opacity::opaque);
 }
@@ -504,6 +501,7 @@ static void initialize_palette() {
 }
 
 void Bitmap::Init(int width, int height, void* data, int pitch, bool destroy) {
+	UpdateRevision();
 	if (!pitch)
 		pitch = width * format.bytes;
 
@@ -523,6 +521,7 @@ void Bitmap::Init(int width, int height, void* data, int pitch, bool destroy) {
 }
 
 void Bitmap::ConvertImage(int& width, int& height, void*& pixels, bool transparent) {
+	UpdateRevision();
 	const DynamicFormat& img_format = transparent ? image_format : opaque_image_format;
 
 	// premultiply alpha
@@ -548,6 +547,9 @@ void* Bitmap::pixels() {
 		return nullptr;
 	}
 
+	// Caller can write to the pixels
+	UpdateRevision();
+
 	return (void*) pixman_image_get_data(bitmap);
 }
 void const* Bitmap::pixels() const {
@@ -570,6 +572,34 @@ int Bitmap::pitch() const {
 	return pixman_image_get_stride(bitmap);
 }
 
+uint64_t Bitmap::GetRevision() const {
+	return revision;
+}
+
+void Bitmap::UpdateRevision() {
+	revision = next_revision++;
+}
+
+void Bitmap::SetClipRects(const std::vector<Rect>& rects) {
+	clip_rects = rects;
+
+	if (rects.empty()) {
+		pixman_image_set_clip_region32(bitmap, nullptr);
+		return;
+	}
+
+	std::vector<pixman_box32_t> boxes;
+	boxes.reserve(rects.size());
+	for (const auto& rect : rects) {
+		boxes.push_back({rect.x, rect.y, rect.x + rect.width, rect.y + rect.height});
+	}
+
+	pixman_region32_t region;
+	pixman_region32_init_rects(&region, boxes.data(), static_cast<int>(boxes.size()));
+	pixman_image_set_clip_region32(bitmap, &region);
+	pixman_region32_fini(&region);
+}
+
 namespace {
 	pixman_image_t *CreateMask(Opacity const& opacity, Rect const& src_rect, Transform const* pxform = nullptr) {
 		if (opacity.IsOpaque())
@@ -598,6 +628,7 @@ namespace {
 } // anonymous namespace
 
 void Bitmap::Blit(int x, int y, Bitmap const& src, Rect const& src_rect, Opacity const& opacity) {
+	UpdateRevision();
 	if (opacity.IsTransparent())
 		return;
 
@@ -616,6 +647,7 @@ void Bitmap::Blit(int x, int y, Bitmap const& src, Rect const& src_rect, Opacity
 }
 
 void Bitmap::BlitFast(int x, int y, Bitmap const & src, Rect const & src_rect, Opacity const & opacity) {
+	UpdateRevision();
 	if (opacity.IsTransparent())
 		return;
 
@@ -639,6 +671,7 @@ void Bitmap::TiledBlit(Rect const& src_rect, Bitmap const& src, Rect const& dst_
 }
 
 void Bitmap::TiledBlit(int ox, int oy, Rect const& src_rect, Bitmap const& src, Rect const& dst_rect, Opacity const& opacity) {
+	UpdateRevision();
 	if (opacity.IsTransparent())
 		return;
 
@@ -675,6 +708,7 @@ void Bitmap::StretchBlit(Bitmap const&  src, Rect const& src_rect, Opacity const
 }
 
 void Bitmap::StretchBlit(Rect const& dst_rect, Bitmap const& src, Rect const& src_rect, Opacity const& opacity) {
+	UpdateRevision();
 	if (opacity.IsTransparent())
 		return;
 
@@ -701,6 +735,7 @@ void Bitmap::StretchBlit(Rect const& dst_rect, Bitmap const& src, Rect const& sr
 }
 
 void Bitmap::TransformBlit(Rect const& dst_rect, Bitmap const& src, Rect const& /* src_rect */, const Transform& xform, Opacity const& opacity) {
+	UpdateRevision();
 	if (opacity.IsTransparent())
 		return;
 
@@ -722,6 +757,7 @@ void Bitmap::TransformBlit(Rect const& dst_rect, Bitmap const& src, Rect const&
 }
 
 void Bitmap::WaverBlit(int x, int y, double zoom_x, double zoom_y, Bitmap const& src, Rect const& src_rect, int depth, double phase, Opacity const& opacity) {
+	UpdateRevision();
 	if (opacity.IsTransparent())
 		return;
 
@@ -766,6 +802,7 @@ static pixman_color_t PixmanColor(const Color &color) {
 }
 
 void Bitmap::Fill(const Color &color) {
+	UpdateRevision();
 	pixman_color_t pcolor = PixmanColor(color);
 	Rect src_rect(0, 0, static_cast<uint16_t>(width()), static_cast<uint16_t>(height()));
 
@@ -782,6 +819,7 @@ void Bitmap::Fill(const Color &color) {
 }
 
 void Bitmap::FillRect(Rect const& dst_rect, const Color &color) {
+	UpdateRevision();
 	pixman_color_t pcolor = PixmanColor(color);
 	pixman_rectangle16_t rect = {
 	static_cast<int16_t>(dst_rect.x),
@@ -793,10 +831,16 @@ void Bitmap::FillRect(Rect const& dst_rect, const Color &color) {
 }
 
 void Bitmap::Clear() {
+	if (!clip_rects.empty()) {
+		ClearRect(GetRect());
+		return;
+	}
+
 	memset(pixels(), '\0', height() * pitch());
 }
 
 void Bitmap::ClearRect(Rect const& dst_rect) {
+	UpdateRevision();
 	pixman_color_t pcolor = {0, 0, 0, 0};
 	pixman_rectangle16_t rect = {
 		static_cast<int16_t>(dst_rect.x),
@@ -808,53 +852,6 @@ void Bitmap::ClearRect(Rect const& dst_rect) {
 	pixman_image_fill_rectangles(PIXMAN_OP_CLEAR, bitmap, &pcolor, 1, &rect);
 }
 
-// Hard light lookup table mapping source color to destination color
-static uint8_t hard_light_lookup[256][256];
-
-static void make_hard_light_lookup() {
-	for (int i = 0; i < 256; ++i) {
-		for (int j = 0; j < 256; ++j) {
-			int res = 0;
-			if (i <= 128)
-				res = (2 * i * j) / 255;
-			else
-				res = 255 - 2 * (255 - i) * (255 - j) / 255;
-			hard_light_lookup[i][j] = res > 255 ? 255 : res < 0 ? 0 : res;
-		}
-	}
-}
-
-// Saturation Tone Inline: Changes a pixel saturation
-static inline void saturation_tone(uint32_t &src_pixel, int saturation, int rs, int gs, int bs, int as) {
-	// Algorithm from OpenPDN (MIT license)
-	// Transformation in Y'CbCr color space
-	uint8_t r = (src_pixel >> rs) & 0xFF;
-	uint8_t g = (src_pixel >> gs) & 0xFF;
-	uint8_t b = (src_pixel >> bs) & 0xFF;
-	uint8_t a = (src_pixel >> as) & 0xFF;
-
-	// Y' = 0.299 R' + 0.587 G' + 0.114 B'
-	uint8_t lum = (7471 * b + 38470 * g + 19595 * r) >> 16;
-
-	// Scale Cb/Cr by scale factor "sat"
-	int red = ((lum * 1024 + (r - lum) * saturation) >> 10);
-	red = red > 255 ? 255 : red < 0 ? 0 : red;
-	int green = ((lum * 1024 + (g - lum) * saturation) >> 10);
-	green = green > 255 ? 255 : green < 0 ? 0 : green;
-	int blue = ((lum * 1024 + (b - lum) * saturation) >> 10);
-	blue = blue > 255 ? 255 : blue < 0 ? 0 : blue;
-
-	src_pixel = ((uint32_t)red << rs) | ((uint32_t)green << gs) | ((uint32_t)blue << bs) | ((uint32_t)a << as);
-}
-
-// Color Tone Inline: Changes color of a pixel by hard light table
-static inline void color_tone(uint32_t &src_pixel, Tone tone, uint8_t hard_light_lookup[256][256], int rs, int gs, int bs, int as) {
-	src_pixel = ((uint32_t)hard_light_lookup[tone.red][(src_pixel >> rs) & 0xFF] << rs)
-		| ((uint32_t)hard_light_lookup[tone.green][(src_pixel >> gs) & 0xFF] << gs)
-		| ((uint32_t)hard_light_lookup[tone.blue][(src_pixel >> bs) & 0xFF] << bs)
-		| ((uint32_t)((src_pixel >> as) & 0xFF) << as);
-}
-
 void Bitmap::ToneBlit(int x, int y, Bitmap const& src, Rect const& src_rect, const Tone &tone, Opacity const& opacity, bool check_alpha) {
 	if (tone == Tone(128,128,128,128)) {
 		if (&src != this) {
@@ -876,103 +873,41 @@ void Bitmap::ToneBlit(int x, int y, Bitmap const& src, Rect const& src_rect, con
 		x, y,
 		src_rect.width, src_rect.height);
 
-	// To implement Saturation and Color:
-	static bool index_made = false;
-	if (!index_made) {
-		make_hard_light_lookup();
-		index_made = true;
-	}
-
-	int as = pixel_format.a.shift;
-	int rs = pixel_format.r.shift;
-	int gs = pixel_format.g.shift;
-	int bs = pixel_format.b.shift;
+	BitmapKernels::Shifts shifts = {
+		pixel_format.r.shift, pixel_format.g.shift, pixel_format.b.shift, pixel_format.a.shift
+	};
+	bool skip_transparent = &src != this || check_alpha;
 	int next_row = pitch() / sizeof(uint32_t);
-	uint32_t* pixels = (uint32_t*)this->pixels();
-	pixels = pixels + (y - 1) * next_row + x;
+	uint32_t* const data = (uint32_t*)this->pixels();
 
-	uint16_t limit_height = std::min<uint16_t>(src_rect.height, height());
-	uint16_t limit_width = std::min<uint16_t>(src_rect.width, width());
-
-	// If Saturation + Color:
-	if (tone.gray != 128 && (tone.red != 128 || tone.green != 128 || tone.blue != 128)) {
-		int sat = tone.gray > 128 ? 1024 + (tone.gray - 128) * 16 : tone.gray * 8;
-
-		if (&src != this || check_alpha) {
-			for (uint16_t i = 0; i < limit_height; ++i) {
-				pixels += next_row;
-				for (uint16_t j = 0; j < limit_width; ++j) {
-					if ((uint8_t)((pixels[j] >> as) & 0xFF) == 0)
-						continue;
-
-					saturation_tone(pixels[j], sat, rs, gs, bs, as);
-					color_tone(pixels[j], tone, hard_light_lookup, rs, gs, bs, as);
-				}
-			}
+	auto tone_area = [&](const Rect& area) {
+		for (int row = 0; row < area.height; ++row) {
+			BitmapKernels::ToneRow(data + (area.y + row) * next_row + area.x, area.width,
+				tone, shifts, skip_transparent);
 		}
-		else {
-			for (uint16_t i = 0; i < limit_height; ++i) {
-				pixels += next_row;
-				for (uint16_t j = 0; j < limit_width; ++j) {
-					saturation_tone(pixels[j], sat, rs, gs, bs, as);
-					color_tone(pixels[j], tone, hard_light_lookup, rs, gs, bs, as);
-				}
-			}
-		}
-	}
-
-	// If Only Saturation:
-	else if (tone.gray != 128) {
-		int sat = tone.gray > 128 ? 1024 + (tone.gray - 128) * 16 : tone.gray * 8;
+	};
 
-		if (&src != this || check_alpha) {
-			for (uint16_t i = 0; i < limit_height; ++i) {
-				pixels += next_row;
-				for (uint16_t j = 0; j < limit_width; ++j) {
-					if ((uint8_t)((pixels[j] >> as) & 0xFF) == 0)
-						continue;
+	uint16_t limit_height = std::min<uint16_t>(src_rect.height, height());
+	uint16_t limit_width = std::min<uint16_t>(src_rect.width, width());
+	Rect area(x, y, limit_width, limit_height);
+	area.Adjust(GetRect());
 
-					saturation_tone(pixels[j], sat, rs, gs, bs, as);
-				}
-			}
-		}
-		else {
-			for (uint16_t i = 0; i < limit_height; ++i) {
-				pixels += next_row;
-				for (uint16_t j = 0; j < limit_width; ++j) {
-					saturation_tone(pixels[j], sat, rs, gs, bs, as);
-				}
-			}
-		}
+	if (clip_rects.empty()) {
+		tone_area(area);
+		return;
 	}
 
-	// If Only Color:
-	else if (tone.red != 128 || tone.green != 128 || tone.blue != 128) {
-		if (&src != this || check_alpha) {
-			for (uint16_t i = 0; i < limit_height; ++i) {
-				pixels += next_row;
-				for (uint16_t j = 0; j < limit_width; ++j) {
-					if ((uint8_t)((pixels[j] >> as) & 0xFF) == 0)
-						continue;
-
-					color_tone(pixels[j], tone, hard_light_lookup, rs, gs, bs, as);
-				}
-			}
+	// The tone is applied in place, pixels outside of the clip must stay untouched
+	for (Rect clip : clip_rects) {
+		clip.Adjust(area);
+		if (!clip.IsEmpty()) {
+			tone_area(clip);
 		}
-		else {
-			for (uint16_t i = 0; i < limit_height; ++i) {
-				pixels += next_row;
-				for (uint16_t j = 0; j < limit_width; ++j) {
-					color_tone(pixels[j], tone, hard_light_lookup, rs, gs, bs, as);
-				}
-			}
-		}
-
 	}
-
 }
 
 void Bitmap::BlendBlit(int x, int y, Bitmap const& src, Rect const& src_rect, const Color& color, Opacity const& opacity) {
+	UpdateRevision();
 	if (color.alpha == 0) {
 		if (&src != this)
 			Blit(x, y, src, src_rect, opacity);
@@ -1001,6 +936,7 @@ void Bitmap::BlendBlit(int x, int y, Bitmap const& src, Rect const& src_rect, co
 }
 
 void Bitmap::FlipBlit(int x, int y, Bitmap const& src, Rect const& src_rect, bool horizontal, bool vertical, Opacity const& opacity) {
+	UpdateRevision();
 	if (!horizontal && !vertical) {
 		Blit(x, y, src, src_rect, opacity);
 		return;
@@ -1023,6 +959,7 @@ void Bitmap::FlipBlit(int x, int y, Bitmap const& src, Rect const& src_rect, boo
 }
 
 void Bitmap::Flip(const Rect& dst_rect, bool horizontal, bool vertical) {
+	UpdateRevision();
 	if (!horizontal && !vertical)
 		return;
 
@@ -1039,6 +976,7 @@ void Bitmap::Flip(const Rect& dst_rect, bool horizontal, bool vertical) {
 }
 
 void Bitmap::MaskedBlit(Rect const& dst_rect, Bitmap const& mask, int mx, int my, Color const& color) {
+	UpdateRevision();
 	pixman_color_t tcolor = {
 		static_cast<uint16_t>(color.red << 8),
 		static_cast<uint16_t>(color.green << 8),
@@ -1058,6 +996,7 @@ void Bitmap::MaskedBlit(Rect const& dst_rect, Bitmap const& mask, int mx, int my
 }
 
 void Bitmap::MaskedBlit(Rect const& dst_rect, Bitmap const& mask, int mx, int my, Bitmap const& src, int sx, int sy) {
+	UpdateRevision();
 	pixman_image_composite32(PIXMAN_OP_OVER,
 							 src.bitmap, mask.bitmap, bitmap,
 							 sx, sy,
@@ -1067,6 +1006,7 @@ void Bitmap::MaskedBlit(Rect const& dst_rect, Bitmap const& mask, int mx, int my
 }
 
 void Bitmap::Blit2x(Rect const& dst_rect, Bitmap const& src, Rect const& src_rect) {
+	UpdateRevision();
 	Transform xform = Transform::Scale(0.5, 0.5);
 
 	pixman_image_set_transform(src.bitmap, &xform.matrix);
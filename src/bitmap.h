@@ -246,6 +246,21 @@ public:
 
 	void CheckPixels(uint32_t flags);
 
+	/**
+	 * Gets a number identifying the current contents of the bitmap.
+	 * It is unique among all bitmaps and changes on every modification.
+	 *
+	 * @return revision
+	 */
+	uint64_t GetRevision() const;
+
+	/**
+	 * Restricts all following drawing operations to the passed areas.
+	 *
+	 * @param rects clip areas, an empty list removes the restriction.
+	 */
+	void SetClipRects(const std::vector<Rect>& rects);
+
 	/**
 	 * Draws text to bitmap using the Font::Default() font.
 	 *
@@ -590,6 +605,12 @@ protected:
 	pixman_op_t GetOperator(pixman_image_t* mask = nullptr) const;
 	bool read_only = false;
 
+	/** Assigns a new revision, called by all operations modifying the pixels. */
+	void UpdateRevision();
+
+	uint64_t revision = 0;
+	std::vector<Rect> clip_rects;
+
 private:
 	/**
 	 * Blits source bitmap with transformation and opacity scaling.
@@ -0,0 +1,451 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include <cstring>
+#include "bitmap_kernels.h"
+#include "bitmap_hslrgb.h"
+
+// The vectorized kernels use the vector extensions of GCC and Clang, the
+// compiler emits SSE2, AVX2 or NEON instructions for them
+#if defined(__GNUC__) && (defined(__clang__) || __GNUC__ >= 9) && \
+	(defined(__SSE2__) || defined(__ARM_NEON) || defined(__ARM_NEON__))
+#  define EP_BITMAP_KERNELS_VECTOR
+#  if defined(__x86_64__) || defined(__i386__)
+#    define EP_BITMAP_KERNELS_AVX2
+#  endif
+#endif
+
+#ifdef EP_BITMAP_KERNELS_VECTOR
+#  define EP_ALWAYS_INLINE inline __attribute__((always_inline))
+#endif
+
+namespace {
+	// Hard light lookup table mapping source color to destination color
+	uint8_t hard_light_lookup[256][256];
+
+	void MakeHardLightLookup() {
+		static bool index_made = false;
+		if (index_made) {
+			return;
+		}
+
+		for (int i = 0; i < 256; ++i) {
+			for (int j = 0; j < 256; ++j) {
+				int res = 0;
+				if (i <= 128)
+					res = (2 * i * j) / 255;
+				else
+					res = 255 - 2 * (255 - i) * (255 - j) / 255;
+				hard_light_lookup[i][j] = res > 255 ? 255 : res < 0 ? 0 : res;
+			}
+		}
+		index_made = true;
+	}
+
+	/** Tone parameters shared by all implementations */
+	struct ToneSetup {
+		BitmapKernels::Shifts shifts;
+		bool skip_transparent;
+
+		bool saturation;
+		int sat;
+
+		bool color;
+		/** Per channel tone value (red, green, blue) */
+		int tone[3];
+		/** Hard light as multiplication: tone <= 128: (k * v) / 255, else 255 - (k * (255 - v)) / 255 */
+		int k[3];
+	};
+
+	ToneSetup MakeToneSetup(const Tone& tone, const BitmapKernels::Shifts& shifts, bool skip_transparent) {
+		ToneSetup setup;
+		setup.shifts = shifts;
+		setup.skip_transparent = skip_transparent;
+
+		setup.saturation = tone.gray != 128;
+		setup.sat = tone.gray > 128 ? 1024 + (tone.gray - 128) * 16 : tone.gray * 8;
+
+		setup.color = tone.red != 128 || tone.green != 128 || tone.blue != 128;
+		setup.tone[0] = tone.red;
+		setup.tone[1] = tone.green;
+		setup.tone[2] = tone.blue;
+		for (int i = 0; i < 3; ++i) {
+			setup.k[i] = setup.tone[i] <= 128 ? 2 * setup.tone[i] : 2 * (255 - setup.tone[i]);
+		}
+
+		return setup;
+	}
+
+	// Saturation Tone Inline: Changes a pixel saturation
+	inline void saturation_tone(uint32_t &src_pixel, int saturation, int rs, int gs, int bs, int as) {
+		// Algorithm from OpenPDN (MIT license)
+		// Transformation in Y'CbCr color space
+		uint8_t r = (src_pixel >> rs) & 0xFF;
+		uint8_t g = (src_pixel >> gs) & 0xFF;
+		uint8_t b = (src_pixel >> bs) & 0xFF;
+		uint8_t a = (src_pixel >> as) & 0xFF;
+
+		// Y' = 0.299 R' + 0.587 G' + 0.114 B'
+		uint8_t lum = (7471 * b + 38470 * g + 19595 * r) >> 16;
+
+		// Scale Cb/Cr by scale factor "sat"
+		int red = ((lum * 1024 + (r - lum) * saturation) >> 10);
+		red = red > 255 ? 255 : red < 0 ? 0 : red;
+		int green = ((lum * 1024 + (g - lum) * saturation) >> 10);
+		green = green > 255 ? 255 : green < 0 ? 0 : green;
+		int blue = ((lum * 1024 + (b - lum) * saturation) >> 10);
+		blue = blue > 255 ? 255 : blue < 0 ? 0 : blue;
+
+		src_pixel = ((uint32_t)red << rs) | ((uint32_t)green << gs) | ((uint32_t)blue << bs) | ((uint32_t)a << as);
+	}
+
+	// Color Tone Inline: Changes color of a pixel by hard light table
+	inline void color_tone(uint32_t &src_pixel, const int tone[3], int rs, int gs, int bs, int as) {
+		src_pixel = ((uint32_t)hard_light_lookup[tone[0]][(src_pixel >> rs) & 0xFF] << rs)
+			| ((uint32_t)hard_light_lookup[tone[1]][(src_pixel >> gs) & 0xFF] << gs)
+			| ((uint32_t)hard_light_lookup[tone[2]][(src_pixel >> bs) & 0xFF] << bs)
+			| ((uint32_t)((src_pixel >> as) & 0xFF) << as);
+	}
+
+	void ToneRowScalar(uint32_t* pixels, int count, const ToneSetup& setup) {
+		int rs = setup.shifts.r;
+		int gs = setup.shifts.g;
+		int bs = setup.shifts.b;
+		int as = setup.shifts.a;
+
+		for (int i = 0; i < count; ++i) {
+			if (setup.skip_transparent && (uint8_t)((pixels[i] >> as) & 0xFF) == 0)
+				continue;
+
+			if (setup.saturation)
+				saturation_tone(pixels[i], setup.sat, rs, gs, bs, as);
+			if (setup.color)
+				color_tone(pixels[i], setup.tone, rs, gs, bs, as);
+		}
+	}
+
+	void HueChangeRowScalar(uint32_t* pixels, int count, int hue) {
+		for (int i = 0; i < count; ++i) {
+			uint32_t pixel = pixels[i];
+			uint8_t r = (pixel>>24) & 0xFF;
+			uint8_t g = (pixel>>16) & 0xFF;
+			uint8_t b = (pixel>> 8) & 0xFF;
+			uint8_t a = pixel & 0xFF;
+			if (a > 0)
+				RGB_adjust_HSL(r, g, b, hue);
+			pixels[i] = ((uint32_t) r << 24) | ((uint32_t) g << 16) | ((uint32_t) b << 8) | (uint32_t) a;
+		}
+	}
+
+#ifdef EP_BITMAP_KERNELS_VECTOR
+	template <int N> struct Vec;
+
+	template <> struct Vec<4> {
+		typedef int32_t Int __attribute__((vector_size(16)));
+		typedef uint32_t UInt __attribute__((vector_size(16)));
+		typedef float Float __attribute__((vector_size(16)));
+	};
+
+	template <> struct Vec<8> {
+		typedef int32_t Int __attribute__((vector_size(32)));
+		typedef uint32_t UInt __attribute__((vector_size(32)));
+		typedef float Float __attribute__((vector_size(32)));
+	};
+
+	// Comparisons return -1 (all bits set) for true lanes.
+	// Macros instead of functions, passing 256 bit vectors to functions
+	// compiled without AVX changes the ABI.
+#define EP_SELECT(mask, a, b) (((a) & (mask)) | ((b) & ~(mask)))
+
+	template <typename V>
+	EP_ALWAYS_INLINE void Clamp255(V& v) {
+		v = EP_SELECT(v > 255, v - v + 255, v);
+		v &= ~(v < 0);
+	}
+
+	// Exact (x / 255) for 0 <= x <= 65280
+	template <typename V, typename U>
+	EP_ALWAYS_INLINE void Div255(V& x) {
+		x = (V)(((U)x * 0x8081u) >> 23);
+	}
+
+	template <int N>
+	EP_ALWAYS_INLINE void ToneBlock(uint32_t* pixels, const ToneSetup& setup) {
+		typedef typename Vec<N>::Int VI;
+		typedef typename Vec<N>::UInt VU;
+
+		VU px;
+		memcpy(&px, pixels, sizeof(px));
+
+		VI r = (VI)((px >> setup.shifts.r) & 0xFFu);
+		VI g = (VI)((px >> setup.shifts.g) & 0xFFu);
+		VI b = (VI)((px >> setup.shifts.b) & 0xFFu);
+		VI a = (VI)((px >> setup.shifts.a) & 0xFFu);
+
+		if (setup.saturation) {
+			VI lum = (7471 * b + 38470 * g + 19595 * r) >> 16;
+			r = (lum * 1024 + (r - lum) * setup.sat) >> 10;
+			g = (lum * 1024 + (g - lum) * setup.sat) >> 10;
+			b = (lum * 1024 + (b - lum) * setup.sat) >> 10;
+			Clamp255(r);
+			Clamp255(g);
+			Clamp255(b);
+		}
+
+		if (setup.color) {
+			VI* channels[3] = { &r, &g, &b };
+			for (int i = 0; i < 3; ++i) {
+				VI& v = *channels[i];
+				if (setup.tone[i] <= 128) {
+					v *= setup.k[i];
+					Div255<VI, VU>(v);
+					Clamp255(v);
+				} else {
+					v = (255 - v) * setup.k[i];
+					Div255<VI, VU>(v);
+					v = 255 - v;
+				}
+			}
+		}
+
+		VU out = ((VU)r << setup.shifts.r) | ((VU)g << setup.shifts.g) |
+			((VU)b << setup.shifts.b) | ((VU)a << setup.shifts.a);
+
+		if (setup.skip_transparent) {
+			out = (VU)EP_SELECT(a == 0, (VI)px, (VI)out);
+		}
+
+		memcpy(pixels, &out, sizeof(out));
+	}
+
+	template <int N>
+	EP_ALWAYS_INLINE void HueChangeBlock(uint32_t* pixels, int hue) {
+		typedef typename Vec<N>::Int VI;
+		typedef typename Vec<N>::UInt VU;
+		typedef typename Vec<N>::Float VF;
+
+		VU px;
+		memcpy(&px, pixels, sizeof(px));
+
+		VI r = (VI)((px >> 24) & 0xFFu);
+		VI g = (VI)((px >> 16) & 0xFFu);
+		VI b = (VI)((px >> 8) & 0xFFu);
+		VI a = (VI)(px & 0xFFu);
+
+		// RGB_to_HSL: The order of the channels decides which channels
+		// are used for the hue, see the switch in bitmap_hslrgb.h
+		VI r_gt_g = r > g;
+		VI r_gt_b = r > b;
+		VI g_lt_b = g < b;
+		VI r_lt_b = r < b;
+		VI g_gt_b = g > b;
+
+		// r > g: O_RGB, O_RBG or O_BRG
+		VI r_max = r_gt_g & r_gt_b;
+		VI brg = r_gt_g & ~r_gt_b;
+		// r <= g: O_GBR, O_BGR or O_GRB
+		VI bgr = ~r_gt_g & r_lt_b & ~g_gt_b;
+		VI grb = ~r_gt_g & ~r_lt_b;
+
+		VI max = EP_SELECT(r_max, r, EP_SELECT(brg | bgr, b, g));
+		VI min = EP_SELECT(r_max, EP_SELECT(g_lt_b, g, b), EP_SELECT(brg, g, EP_SELECT(grb, b, r)));
+		VI num = EP_SELECT(r_max, g - b, EP_SELECT(brg | bgr, r - g, b - r));
+		VI offset = EP_SELECT(r_max, g_lt_b & 0x600, EP_SELECT(brg | bgr, max - max + 0x400, max - max + 0x200));
+
+		VI c = max - min;
+		VI l2 = max + min;
+
+		// Truncating float division is exact for these value ranges
+		VI c_zero = c == 0;
+		VF quot = __builtin_convertvector(num * 0x100, VF) / __builtin_convertvector(c | (c_zero & 1), VF);
+		VI h = (__builtin_convertvector(quot, VI) + offset) & ~c_zero;
+
+		VI l2_zero = l2 == 0;
+		VI d = EP_SELECT(l2 > 0xFF, 0x1FF - l2, l2);
+		quot = __builtin_convertvector(c * 0x100, VF) / __builtin_convertvector(d | (l2_zero & 1), VF);
+		VI s = __builtin_convertvector(quot, VI) & ~l2_zero;
+		VI l = (l2 >> 1) & ~l2_zero;
+
+		// HSL_adjust
+		h += hue;
+		h = EP_SELECT(h > 0x600, h - 0x600, h);
+		s = EP_SELECT(s > 0xFF, s - s + 0xFF, s);
+		Clamp255(l);
+
+		// HSL_to_RGB
+		l2 = 2 * l;
+		c = (s * EP_SELECT(l2 > 0xFF, 0x1FF - l2, l2)) >> 8;
+		VI m = (l2 - c) >> 1;
+		VI h0 = h & 0xFF;
+		VI h1 = 0xFF - h0;
+		VI sector = h >> 8;
+
+		VI mc = m + c;
+		VI m0 = m + ((h0 * c) >> 8);
+		VI m1 = m + ((h1 * c) >> 8);
+
+		VI s0 = sector == 0;
+		VI s1 = sector == 1;
+		VI s2 = sector == 2;
+		VI s3 = sector == 3;
+		VI s4 = sector == 4;
+		VI s5 = sector == 5;
+
+		// Sector 6 (h == 0x600) keeps the input color
+		VI new_r = EP_SELECT(s0 | s5, mc, EP_SELECT(s1, m1, EP_SELECT(s4, m0, EP_SELECT(s2 | s3, m, r))));
+		VI new_g = EP_SELECT(s1 | s2, mc, EP_SELECT(s0, m0, EP_SELECT(s3, m1, EP_SELECT(s4 | s5, m, g))));
+		VI new_b = EP_SELECT(s3 | s4, mc, EP_SELECT(s2, m0, EP_SELECT(s5, m1, EP_SELECT(s0 | s1, m, b))));
+
+		VU out = ((VU)(new_r & 0xFF) << 24) | ((VU)(new_g & 0xFF) << 16) | ((VU)(new_b & 0xFF) << 8) | (VU)a;
+		out = (VU)EP_SELECT(a == 0, (VI)px, (VI)out);
+
+		memcpy(pixels, &out, sizeof(out));
+	}
+
+	template <int N>
+	EP_ALWAYS_INLINE void ToneRowVector(uint32_t* pixels, int count, const ToneSetup& setup) {
+		int i = 0;
+		for (; i + N <= count; i += N) {
+			ToneBlock<N>(pixels + i, setup);
+		}
+		ToneRowScalar(pixels + i, count - i, setup);
+	}
+
+#undef EP_SELECT
+
+	template <int N>
+	EP_ALWAYS_INLINE void HueChangeRowVector(uint32_t* pixels, int count, int hue) {
+		int i = 0;
+		for (; i + N <= count; i += N) {
+			HueChangeBlock<N>(pixels + i, hue);
+		}
+		HueChangeRowScalar(pixels + i, count - i, hue);
+	}
+
+	void ToneRow128(uint32_t* pixels, int count, const ToneSetup& setup) {
+		ToneRowVector<4>(pixels, count, setup);
+	}
+
+	void HueChangeRow128(uint32_t* pixels, int count, int hue) {
+		HueChangeRowVector<4>(pixels, count, hue);
+	}
+#endif
+
+#ifdef EP_BITMAP_KERNELS_AVX2
+	__attribute__((target("avx2")))
+	void ToneRow256(uint32_t* pixels, int count, const ToneSetup& setup) {
+		ToneRowVector<8>(pixels, count, setup);
+	}
+
+	__attribute__((target("avx2")))
+	void HueChangeRow256(uint32_t* pixels, int count, int hue) {
+		HueChangeRowVector<8>(pixels, count, hue);
+	}
+#endif
+
+	BitmapKernels::Implementation Resolve(BitmapKernels::Implementation impl) {
+		if (impl != BitmapKernels::Impl_Best) {
+			return impl;
+		}
+
+		static const BitmapKernels::Implementation best =
+			BitmapKernels::IsSupported(BitmapKernels::Impl_Vector256) ? BitmapKernels::Impl_Vector256 :
+			BitmapKernels::IsSupported(BitmapKernels::Impl_Vector128) ? BitmapKernels::Impl_Vector128 :
+			BitmapKernels::Impl_Scalar;
+		return best;
+	}
+}
+
+bool BitmapKernels::IsSupported(Implementation impl) {
+	switch (impl) {
+		case Impl_Scalar:
+		case Impl_Best:
+			return true;
+		case Impl_Vector128:
+#ifdef EP_BITMAP_KERNELS_VECTOR
+			return true;
+#else
+			return false;
+#endif
+		case Impl_Vector256:
+#ifdef EP_BITMAP_KERNELS_AVX2
+			return __builtin_cpu_supports("avx2");
+#else
+			return false;
+#endif
+	}
+	return false;
+}
+
+const char* BitmapKernels::GetName(Implementation impl) {
+	switch (Resolve(impl)) {
+		case Impl_Scalar:
+			return "scalar";
+		case Impl_Vector128:
+#if defined(__SSE2__)
+			return "SSE2";
+#else
+			return "NEON";
+#endif
+		case Impl_Vector256:
+			return "AVX2";
+		case Impl_Best:
+			break;
+	}
+	return "";
+}
+
+void BitmapKernels::ToneRow(uint32_t* pixels, int count, const Tone& tone, const Shifts& shifts,
+		bool skip_transparent, Implementation impl) {
+	MakeHardLightLookup();
+	ToneSetup setup = MakeToneSetup(tone, shifts, skip_transparent);
+
+	switch (Resolve(impl)) {
+#ifdef EP_BITMAP_KERNELS_AVX2
+		case Impl_Vector256:
+			ToneRow256(pixels, count, setup);
+			return;
+#endif
+#ifdef EP_BITMAP_KERNELS_VECTOR
+		case Impl_Vector128:
+			ToneRow128(pixels, count, setup);
+			return;
+#endif
+		default:
+			ToneRowScalar(pixels, count, setup);
+			return;
+	}
+}
+
+void BitmapKernels::HueChangeRow(uint32_t* pixels, int count, int hue, Implementation impl) {
+	switch (Resolve(impl)) {
+#ifdef EP_BITMAP_KERNELS_AVX2
+		case Impl_Vector256:
+			HueChangeRow256(pixels, count, hue);
+			return;
+#endif
+#ifdef EP_BITMAP_KERNELS_VECTOR
+		case Impl_Vector128:
+			HueChangeRow128(pixels, count, hue);
+			return;
+#endif
+		default:
+			HueChangeRowScalar(pixels, count, hue);
+			return;
+	}
+}
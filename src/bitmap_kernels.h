@@ -0,0 +1,89 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_BITMAP_KERNELS_H
+#define EP_BITMAP_KERNELS_H
+
+// Headers
+#include <cstdint>
+#include "tone.h"
+
+/**
+ * BitmapKernels namespace.
+ * Per pixel effects of Bitmap working on rows of 32 bit pixels.
+ * Vectorized implementations are selected at runtime and produce exactly
+ * the same output as the scalar ones.
+ */
+namespace BitmapKernels {
+	enum Implementation {
+		/** Plain C++, one pixel at a time */
+		Impl_Scalar,
+		/** 128 bit vectors (SSE2 or NEON) */
+		Impl_Vector128,
+		/** 256 bit vectors (AVX2), checked at runtime */
+		Impl_Vector256,
+		/** Fastest implementation supported by the CPU */
+		Impl_Best
+	};
+
+	/** Bit positions of the channels in a 32 bit pixel */
+	struct Shifts {
+		int r;
+		int g;
+		int b;
+		int a;
+	};
+
+	/**
+	 * @param impl implementation
+	 * @return whether the implementation is available on this CPU
+	 */
+	bool IsSupported(Implementation impl);
+
+	/**
+	 * @param impl implementation, Impl_Best is resolved
+	 * @return name of the implementation
+	 */
+	const char* GetName(Implementation impl);
+
+	/**
+	 * Applies a tone (saturation and hard light color) in place.
+	 *
+	 * @param pixels pixels to change
+	 * @param count number of pixels
+	 * @param tone tone to apply, must not be the neutral tone
+	 * @param shifts channel positions of the pixel format
+	 * @param skip_transparent whether pixels with alpha 0 stay untouched
+	 * @param impl implementation to use
+	 */
+	void ToneRow(uint32_t* pixels, int count, const Tone& tone, const Shifts& shifts,
+		bool skip_transparent, Implementation impl = Impl_Best);
+
+	/**
+	 * Rotates the hue in place.
+	 * The pixels are RGBA with red in the most significant byte.
+	 * Pixels with alpha 0 stay untouched.
+	 *
+	 * @param pixels pixels to change
+	 * @param count number of pixels
+	 * @param hue rotation in 0x000 - 0x600 (0x100 per 60 degree)
+	 * @param impl implementation to use
+	 */
+	void HueChangeRow(uint32_t* pixels, int count, int hue, Implementation impl = Impl_Best);
+}
+
+#endif
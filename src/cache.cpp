@@ -20,8 +20,11 @@
 #  pragma warning(disable: 4003)
 #endif
 
+#include <algorithm>
+#include <list>
 #include <map>
 #include <tuple>
+#include <unordered_map>
 
 #include "async_handler.h"
 #include "cache.h"
@@ -36,16 +39,28 @@
 namespace {
 	using key_type = std::tuple<std::string,std::string,bool>;
 
+	struct KeyHash {
+		size_t operator()(const key_type& key) const {
+			size_t h = std::hash<std::string>()(std::get<0>(key));
+			h ^= std::hash<std::string>()(std::get<1>(key)) + 0x9e3779b9 + (h << 6) + (h >> 2);
+			return h ^ static_cast<size_t>(std::get<2>(key));
+		}
+	};
+
 	struct CacheItem {
+		key_type key;
 		BitmapRef bitmap;
-		uint32_t last_access;
 	};
 
-	using tile_pair = std::pair<std::string, int>;
+	// Most recently used item first
+	using lru_type = std::list<CacheItem>;
+	lru_type lru;
 
-	using cache_type = std::map<key_type, CacheItem>;
+	using cache_type = std::unordered_map<key_type, lru_type::iterator, KeyHash>;
 	cache_type cache;
 
+	using tile_pair = std::pair<std::string, int>;
+
 	using cache_tiles_type = std::map<tile_pair, std::weak_ptr<Bitmap>>;
 	cache_tiles_type cache_tiles;
 
@@ -54,63 +69,127 @@ namespace {
 	using cache_effect_type = std::map<effect_key_type, std::weak_ptr<Bitmap>>;
 	cache_effect_type cache_effects;
 
+	// Map sizes at which the weak caches are purged next
+	constexpr size_t purge_min_size = 64;
+	size_t cache_tiles_purge_size = purge_min_size;
+	size_t cache_effects_purge_size = purge_min_size;
+
 	std::string system_name;
 
-	constexpr int cache_limit = 10 * 1024 * 1024;
-	size_t cache_size = 0;
+	size_t cache_limit = 10 * 1024 * 1024;
+	Cache::Stats stats;
 
+	size_t GetSize(const BitmapRef& bmp) {
+		return bmp ? bmp->GetSize() : 0;
+	}
+
+	void RemoveItem(lru_type::iterator it) {
+		stats.size -= GetSize(it->bitmap);
+		cache.erase(it->key);
+		lru.erase(it);
+	}
+
+	/**
+	 * Frees unreferenced bitmaps in least recently used order until the
+	 * cache is below the memory limit.
+	 * Bitmaps still referenced elsewhere are in use and count as recently
+	 * used, freeing them would not release any memory.
+	 */
 	void FreeBitmapMemory() {
-		int32_t cur_ticks = DisplayUi->GetTicks();
+		size_t remaining = lru.size();
 
-		for (auto& i : cache) {
-			if (i.second.bitmap.use_count() != 1) {
-				// Bitmap is referenced
-				continue;
-			}
+		while (stats.size > cache_limit && remaining > 0) {
+			--remaining;
 
-			if (cache_size <= cache_limit && cur_ticks - i.second.last_access < 3000) {
-				// Below memory limit and last access < 3s
+			auto it = std::prev(lru.end());
+			if (it->bitmap.use_count() > 1) {
+				lru.splice(lru.begin(), lru, it);
 				continue;
 			}
 
 #ifdef CACHE_DEBUG
-			Output::Debug("Freeing memory of %s/%s %d %d",
-						  std::get<0>(i.first).c_str(), std::get<1>(i.first).c_str(), i.second.last_access, cur_ticks);
+			Output::Debug("Freeing memory of %s/%s",
+						  std::get<0>(it->key).c_str(), std::get<1>(it->key).c_str());
 #endif
 
-			cache_size -= i.second.bitmap->GetSize();
-			i.second.bitmap.reset();
+			RemoveItem(it);
+			++stats.evictions;
 		}
 
 #ifdef CACHE_DEBUG
-		Output::Debug("Bitmap cache size: %f", cache_size / 1024.0 / 1024);
+		Output::Debug("Bitmap cache size: %f", stats.size / 1024.0 / 1024);
 #endif
 	}
 
+	/**
+	 * Removes the entries of expired bitmaps from a weak cache.
+	 * Only scans the map when it doubled in size since the last purge,
+	 * which keeps the cost per insertion constant.
+	 */
+	template <typename T>
+	void PurgeExpired(T& weak_cache, size_t& purge_size) {
+		if (weak_cache.size() < purge_size) {
+			return;
+		}
+
+		for (auto it = weak_cache.begin(); it != weak_cache.end();) {
+			if (it->second.expired()) {
+				it = weak_cache.erase(it);
+			} else {
+				++it;
+			}
+		}
+
+		purge_size = std::max(purge_min_size, weak_cache.size() * 2);
+	}
+
+	/**
+	 * Looks up a bitmap and marks it as most recently used.
+	 *
+	 * @param key cache key
+	 * @return bitmap or null when not cached
+	 */
+	BitmapRef FindInCache(const key_type& key) {
+		const cache_type::iterator it = cache.find(key);
+
+		if (it == cache.end() || !it->second->bitmap) {
+			++stats.misses;
+			return BitmapRef();
+		}
+
+		++stats.hits;
+		lru.splice(lru.begin(), lru, it->second);
+		return it->second->bitmap;
+	}
+
 	BitmapRef AddToCache(const key_type& key, BitmapRef bmp) {
-		if (bmp) {
-			cache_size += bmp->GetSize();
+		const cache_type::iterator it = cache.find(key);
+		if (it != cache.end()) {
+			RemoveItem(it->second);
+		}
+
+		lru.push_front({key, bmp});
+		cache[key] = lru.begin();
+		stats.size += GetSize(bmp);
+
 #ifdef CACHE_DEBUG
-			Output::Debug("Bitmap cache size (Add): %f", cache_size / 1024.0 / 1024.0);
+		Output::Debug("Bitmap cache size (Add): %f", stats.size / 1024.0 / 1024.0);
 #endif
-		}
 
-		return (cache[key] = {bmp, DisplayUi->GetTicks()}).bitmap;
+		FreeBitmapMemory();
+
+		return bmp;
 	}
 
 	BitmapRef LoadBitmap(const std::string& folder_name, const std::string& filename,
 						 bool transparent, const uint32_t flags) {
 		const key_type key(folder_name, filename, transparent);
 
-		const cache_type::iterator it = cache.find(key);
+		BitmapRef bmp = FindInCache(key);
 
-		if (it == cache.end() || !it->second.bitmap) {
+		if (!bmp) {
 			const std::string path = FileFinder::FindImage(folder_name, filename);
 
-			BitmapRef bmp = BitmapRef();
-
-			FreeBitmapMemory();
-
 			if (path.empty()) {
 				Output::Warning("Image not found: %s/%s", folder_name.c_str(), filename.c_str());
 			} else {
@@ -121,10 +200,9 @@ namespace {
 			}
 
 			return AddToCache(key, bmp);
-		} else {
-			it->second.last_access = DisplayUi->GetTicks();
-			return it->second.bitmap;
 		}
+
+		return bmp;
 	}
 
 	struct Material {
@@ -205,10 +283,7 @@ namespace {
 
 		const Spec& s = spec[T];
 
-		FreeBitmapMemory();
-
 		BitmapRef bitmap = Bitmap::Create(s.max_width, s.max_height, false);
-		cache_size += bitmap->GetSize();
 
 		// ToDo: Maybe use different renderers depending on material
 		// Will look ugly for some image types
@@ -232,18 +307,13 @@ namespace {
 
 		const key_type key(folder_name, filename, false);
 
-		const cache_type::iterator it = cache.find(key);
-
-		if (it == cache.end() || !it->second.bitmap) {
-			FreeBitmapMemory();
-
-			BitmapRef bitmap = s.dummy_renderer();
+		BitmapRef bitmap = FindInCache(key);
 
-			return AddToCache(key, bitmap);
-		} else {
-			it->second.last_access = DisplayUi->GetTicks();
-			return it->second.bitmap;
+		if (!bitmap) {
+			return AddToCache(key, s.dummy_renderer());
 		}
+
+		return bitmap;
 	}
 
 	template<Material::Type T>
@@ -376,12 +446,11 @@ BitmapRef Cache::System(const std::string& file) {
 BitmapRef Cache::Exfont() {
 	const key_type hash("ExFont", "ExFont", false);
 
-	cache_type::iterator const it = cache.find(hash);
+	BitmapRef exfont_img = FindInCache(hash);
 
-	if (it == cache.end() || !it->second.bitmap) {
+	if (!exfont_img) {
 		// Allow overwriting of built-in exfont with a custom ExFont image file
 		// exfont_custom is filled by Player::CreateGameObjects
-		BitmapRef exfont_img;
 		if (!exfont_custom.empty()) {
 			exfont_img = Bitmap::Create(exfont_custom.data(), exfont_custom.size(), true);
 		}
@@ -391,10 +460,9 @@ BitmapRef Cache::Exfont() {
 		}
 
 		return AddToCache(hash, exfont_img);
-	} else {
-		it->second.last_access = DisplayUi->GetTicks();
-		return it->second.bitmap;
 	}
+
+	return exfont_img;
 }
 
 BitmapRef Cache::Tile(const std::string& filename, int tile_id) {
@@ -426,6 +494,8 @@ BitmapRef Cache::Tile(const std::string& filename, int tile_id) {
 		rect.x += sub_tile_id % 6 * 16;
 		rect.y += sub_tile_id / 6 * 16;
 
+		PurgeExpired(cache_tiles, cache_tiles_purge_size);
+
 		return(cache_tiles[key] = Bitmap::Create(*chipset, rect)).lock();
 	} else { return it->second.lock(); }
 }
@@ -476,13 +546,16 @@ BitmapRef Cache::SpriteEffect(const BitmapRef& src_bitmap, const Rect& rect, boo
 
 		assert(bitmap_effects && "Effect cache used but no effect applied!");
 
+		PurgeExpired(cache_effects, cache_effects_purge_size);
+
 		return(cache_effects[key] = bitmap_effects).lock();
 	} else { return it->second.lock(); }
 }
 
 void Cache::Clear() {
 	cache.clear();
-	cache_size = 0;
+	lru.clear();
+	stats.size = 0;
 
 	for (cache_tiles_type::const_iterator i = cache_tiles.begin(); i != cache_tiles.end(); ++i) {
 		if (i->second.expired()) { continue; }
@@ -491,6 +564,22 @@ void Cache::Clear() {
 	}
 
 	cache_tiles.clear();
+	cache_tiles_purge_size = purge_min_size;
+
+	cache_effects.clear();
+	cache_effects_purge_size = purge_min_size;
+}
+
+void Cache::SetSizeLimit(size_t bytes) {
+	cache_limit = bytes;
+	FreeBitmapMemory();
+}
+
+Cache::Stats Cache::GetStats() {
+	Stats result = stats;
+	result.limit = cache_limit;
+	result.count = lru.size();
+	return result;
 }
 
 void Cache::SetSystemName(std::string const& filename) {
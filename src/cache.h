@@ -19,6 +19,7 @@
 #define EP_CACHE_H
 
 // Headers
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -58,6 +59,34 @@ namespace Cache {
 
 	void Clear();
 
+	/** Counters of the bitmap cache, used by the debug scene. */
+	struct Stats {
+		/** Lookups served from the cache */
+		uint64_t hits = 0;
+		/** Lookups which loaded the bitmap */
+		uint64_t misses = 0;
+		/** Bitmaps freed to stay below the memory limit */
+		uint64_t evictions = 0;
+		/** Number of cached bitmaps */
+		size_t count = 0;
+		/** Memory used by the cached bitmaps in bytes */
+		size_t size = 0;
+		/** Memory limit in bytes */
+		size_t limit = 0;
+	};
+
+	/**
+	 * Sets the memory limit of the bitmap cache.
+	 * When the limit is exceeded unreferenced bitmaps are freed in least
+	 * recently used order.
+	 *
+	 * @param bytes memory limit in bytes
+	 */
+	void SetSizeLimit(size_t bytes);
+
+	/** @return current counters of the bitmap cache */
+	Stats GetStats();
+
 	BitmapRef System();
 	void SetSystemName(std::string const& filename);
 
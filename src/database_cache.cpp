@@ -0,0 +1,228 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include "database_cache.h"
+#include "data.h"
+#include "filefinder.h"
+#include "ldb_reader.h"
+#include "lmt_reader.h"
+#include "main_data.h"
+#include "options.h"
+#include "output.h"
+#include "version.h"
+
+namespace {
+	// Layout: magic, format version, file key, encoding, size of the
+	// database, size of the map tree, checksum, database, map tree.
+	// The database and map tree are stored as LCF with UTF-8 strings.
+	constexpr char magic[8] = { 'E', 'P', 'D', 'B', 'S', 'N', 'A', 'P' };
+	constexpr uint32_t format_version = 1;
+	constexpr uint32_t max_string_size = 256;
+
+	struct Header {
+		std::string files;
+		std::string encoding;
+		uint32_t ldb_size = 0;
+		uint32_t lmt_size = 0;
+		uint32_t checksum = 0;
+	};
+}
+
+static void WriteU32(std::string& out, uint32_t value) {
+	for (int i = 0; i < 4; ++i) {
+		out.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+	}
+}
+
+static void WriteString(std::string& out, const std::string& str) {
+	WriteU32(out, static_cast<uint32_t>(str.size()));
+	out += str;
+}
+
+static uint32_t ReadU32(std::istream& stream) {
+	uint8_t bytes[4] = {};
+	stream.read(reinterpret_cast<char*>(bytes), 4);
+	return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+static std::string ReadString(std::istream& stream) {
+	const uint32_t size = ReadU32(stream);
+	if (!stream || size > max_string_size) {
+		stream.setstate(std::ios_base::failbit);
+		return "";
+	}
+	std::string str(size, '\0');
+	stream.read(&str[0], size);
+	return str;
+}
+
+static uint32_t Checksum(const std::string& data) {
+	// FNV-1a
+	uint32_t hash = 2166136261u;
+	for (unsigned char c : data) {
+		hash = (hash ^ c) * 16777619u;
+	}
+	return hash;
+}
+
+static std::string GetPath() {
+	return FileFinder::MakePath(Main_Data::GetSavePath(), DATABASE_CACHE_NAME);
+}
+
+/**
+ * Identifies the files a snapshot was created from.
+ *
+ * @return key or empty string when the files cannot be identified
+ */
+static std::string GetFileKey(const std::string& ldb, const std::string& lmt) {
+	std::string key;
+	WriteString(key, PLAYER_VERSION);
+	for (const std::string* file : { &ldb, &lmt }) {
+		const int64_t size = FileFinder::GetFileSize(*file);
+		const int64_t time = FileFinder::GetFileModificationTime(*file);
+		if (size == -1 || time == -1) {
+			return "";
+		}
+		WriteU32(key, static_cast<uint32_t>(size));
+		WriteU32(key, static_cast<uint32_t>(size >> 32));
+		WriteU32(key, static_cast<uint32_t>(time));
+		WriteU32(key, static_cast<uint32_t>(time >> 32));
+	}
+	return key;
+}
+
+/**
+ * Opens the snapshot and reads its header.
+ *
+ * @return stream positioned at the database or nullptr when there is no
+ *         snapshot for the files
+ */
+static std::shared_ptr<std::fstream> OpenSnapshot(const std::string& ldb, const std::string& lmt, Header& header) {
+	const std::string path = GetPath();
+	if (!FileFinder::Exists(path)) {
+		return nullptr;
+	}
+
+	const std::string files = GetFileKey(ldb, lmt);
+	if (files.empty()) {
+		return nullptr;
+	}
+
+	auto stream = FileFinder::openUTF8(path, std::ios_base::in | std::ios_base::binary);
+	if (!stream) {
+		return nullptr;
+	}
+
+	char file_magic[sizeof(magic)] = {};
+	stream->read(file_magic, sizeof(magic));
+	if (!std::equal(magic, magic + sizeof(magic), file_magic) || ReadU32(*stream) != format_version) {
+		return nullptr;
+	}
+
+	header.files = ReadString(*stream);
+	header.encoding = ReadString(*stream);
+	header.ldb_size = ReadU32(*stream);
+	header.lmt_size = ReadU32(*stream);
+	header.checksum = ReadU32(*stream);
+
+	if (!*stream || header.files != files) {
+		return nullptr;
+	}
+
+	// Reject sizes beyond the end of the file before allocating
+	const int64_t file_size = FileFinder::GetFileSize(path);
+	if (static_cast<int64_t>(header.ldb_size) + header.lmt_size > file_size) {
+		return nullptr;
+	}
+
+	return stream;
+}
+
+bool DatabaseCache::Load(const std::string& ldb, const std::string& lmt, const std::string& encoding) {
+	Header header;
+	auto stream = OpenSnapshot(ldb, lmt, header);
+	if (!stream || header.encoding != encoding) {
+		return false;
+	}
+
+	std::string data(static_cast<size_t>(header.ldb_size) + header.lmt_size, '\0');
+	stream->read(&data[0], data.size());
+	if (static_cast<size_t>(stream->gcount()) != data.size() || Checksum(data) != header.checksum) {
+		Output::Debug("Database cache is damaged, ignoring it");
+		return false;
+	}
+
+	// The strings are already UTF-8, no conversion needed
+	if (!LDB_Reader::Load(data.data(), header.ldb_size, "") ||
+		!LMT_Reader::Load(data.data() + header.ldb_size, header.lmt_size, "")) {
+		Output::Debug("Database cache is damaged, ignoring it");
+		Data::Clear();
+		return false;
+	}
+
+	return true;
+}
+
+bool DatabaseCache::Save(const std::string& ldb, const std::string& lmt, const std::string& encoding) {
+	const std::string files = GetFileKey(ldb, lmt);
+	if (files.empty()) {
+		return false;
+	}
+
+	std::ostringstream ldb_stream;
+	std::ostringstream lmt_stream;
+	if (!LDB_Reader::Save(ldb_stream, "", SaveOpt::ePreserveHeader) ||
+		!LMT_Reader::Save(lmt_stream, "", SaveOpt::ePreserveHeader)) {
+		return false;
+	}
+
+	const std::string ldb_data = ldb_stream.str();
+	const std::string data = ldb_data + lmt_stream.str();
+
+	std::string header(magic, sizeof(magic));
+	WriteU32(header, format_version);
+	WriteString(header, files);
+	WriteString(header, encoding);
+	WriteU32(header, static_cast<uint32_t>(ldb_data.size()));
+	WriteU32(header, static_cast<uint32_t>(data.size() - ldb_data.size()));
+	WriteU32(header, Checksum(data));
+
+	const std::string path = GetPath();
+	auto stream = FileFinder::openUTF8(path, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+	if (!stream) {
+		Output::Debug("Could not write database cache %s", path.c_str());
+		return false;
+	}
+
+	stream->write(header.data(), header.size());
+	stream->write(data.data(), data.size());
+	return stream->good();
+}
+
+std::string DatabaseCache::GetEncoding(const std::string& ldb, const std::string& lmt) {
+	Header header;
+	if (!OpenSnapshot(ldb, lmt, header)) {
+		return "";
+	}
+	return header.encoding;
+}
@@ -0,0 +1,64 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_DATABASE_CACHE_H
+#define EP_DATABASE_CACHE_H
+
+// Headers
+#include <string>
+
+/**
+ * DatabaseCache namespace.
+ * Snapshot of the decoded database and map tree in the save directory.
+ * The snapshot stores all strings as UTF-8 and is only used while the
+ * size and modification time of the database and map tree files and
+ * the Player version match the ones it was created from.
+ */
+namespace DatabaseCache {
+	/**
+	 * Loads the database and map tree from the snapshot.
+	 * Data is cleared when the snapshot is damaged.
+	 *
+	 * @param ldb path to the database
+	 * @param lmt path to the map tree
+	 * @param encoding encoding the files are read with
+	 * @return whether a matching snapshot was loaded
+	 */
+	bool Load(const std::string& ldb, const std::string& lmt, const std::string& encoding);
+
+	/**
+	 * Writes the loaded database and map tree to the snapshot.
+	 *
+	 * @param ldb path to the database
+	 * @param lmt path to the map tree
+	 * @param encoding encoding the files were read with
+	 * @return whether the snapshot was written
+	 */
+	bool Save(const std::string& ldb, const std::string& lmt, const std::string& encoding);
+
+	/**
+	 * Gets the encoding the snapshot was created with, used to skip
+	 * the encoding detection.
+	 *
+	 * @param ldb path to the database
+	 * @param lmt path to the map tree
+	 * @return encoding or empty string when there is no matching snapshot
+	 */
+	std::string GetEncoding(const std::string& ldb, const std::string& lmt);
+}
+
+#endif
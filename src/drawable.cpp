@@ -15,9 +15,105 @@
  * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <cstring>
 #include "drawable.h"
+#include "bitmap.h"
 #include "rpg_savepicture.h"
 
+DrawState& DrawState::Cover(const Rect& area) {
+	if (area.IsEmpty()) {
+		return *this;
+	}
+	if (rect.IsEmpty()) {
+		rect = area;
+		return *this;
+	}
+
+	int right = std::max(rect.x + rect.width, area.x + area.width);
+	int bottom = std::max(rect.y + rect.height, area.y + area.height);
+	rect.x = std::min(rect.x, area.x);
+	rect.y = std::min(rect.y, area.y);
+	rect.width = right - rect.x;
+	rect.height = bottom - rect.y;
+	return *this;
+}
+
+DrawState& DrawState::Mix(uint64_t value) {
+	// FNV-1a over the 8 bytes of the value
+	for (int i = 0; i < 8; ++i) {
+		signature ^= (value >> (i * 8)) & 0xFF;
+		signature *= 1099511628211ULL;
+	}
+	return *this;
+}
+
+DrawState& DrawState::Add(double value) {
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return Mix(bits);
+}
+
+DrawState& DrawState::Add(const void* value) {
+	return Mix(reinterpret_cast<uintptr_t>(value));
+}
+
+DrawState& DrawState::Add(const Rect& value) {
+	return Add(value.x).Add(value.y).Add(value.width).Add(value.height);
+}
+
+DrawState& DrawState::Add(const Tone& value) {
+	return Add(value.red).Add(value.green).Add(value.blue).Add(value.gray);
+}
+
+DrawState& DrawState::Add(const Color& value) {
+	return Add(value.red).Add(value.green).Add(value.blue).Add(value.alpha);
+}
+
+DrawState& DrawState::Add(const BitmapRef& value) {
+	return Mix(value ? value->GetRevision() : 0);
+}
+
+uint64_t DrawState::GetSignature() const {
+	return signature;
+}
+
+bool Drawable::GetDrawState(DrawState&) {
+	return false;
+}
+
+bool Drawable::UpdateDamage(std::vector<Rect>& damage) {
+	DrawState state;
+	if (!GetDrawState(state)) {
+		last_draw_state_valid = false;
+		damage_untracked = true;
+		return false;
+	}
+	// Catches reordering of overlapping drawables
+	state.Add(GetZ());
+
+	if (!last_draw_state_valid) {
+		// Untracked in the last frame means it was a full redraw anyway
+		damage.push_back(state.rect);
+	} else if (state.rect != last_draw_state.rect || state.GetSignature() != last_draw_state.GetSignature()) {
+		damage.push_back(last_draw_state.rect);
+		damage.push_back(state.rect);
+	}
+
+	last_draw_state = state;
+	last_draw_state_valid = true;
+	damage_untracked = false;
+	return true;
+}
+
+bool Drawable::GetLastDrawRect(Rect& rect) const {
+	if (damage_untracked) {
+		return false;
+	}
+	rect = last_draw_state_valid ? last_draw_state.rect : Rect();
+	return true;
+}
+
 int Drawable::GetPriorityForMapLayer(int which) {
 	switch (which) {
 		case RPG::SavePicture::MapLayer_parallax:
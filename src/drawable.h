@@ -18,6 +18,15 @@
 #ifndef EP_DRAWABLE_H
 #define EP_DRAWABLE_H
 
+// Headers
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include "color.h"
+#include "memory_management.h"
+#include "rect.h"
+#include "tone.h"
+
 // What kind of drawable is the current one?
 enum DrawableType {
 	TypeWindow,
@@ -55,6 +64,60 @@ enum Priority {
 	Priority_Maximum = 100 << 24
 };
 
+/**
+ * Describes what a drawable renders in a frame: The covered screen area and
+ * a signature over all properties which influence the rendering.
+ * Graphics compares the states of two frames to find the changed areas.
+ */
+class DrawState {
+public:
+	/** Screen area covered by the drawable, empty when nothing is drawn. */
+	Rect rect;
+
+	/**
+	 * Extends the covered screen area to include the passed area.
+	 *
+	 * @param area screen area
+	 * @return this state
+	 */
+	DrawState& Cover(const Rect& area);
+
+	/**
+	 * Adds a property to the signature.
+	 *
+	 * @param value property value
+	 * @return this state
+	 */
+	template <typename T>
+	typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value, DrawState&>::type
+	Add(T value) {
+		return Mix(static_cast<uint64_t>(value));
+	}
+
+	DrawState& Add(double value);
+	DrawState& Add(const void* value);
+	DrawState& Add(const Rect& value);
+	DrawState& Add(const Tone& value);
+	DrawState& Add(const Color& value);
+
+	/**
+	 * Adds the contents of a bitmap to the signature.
+	 * Uses the bitmap revision, no pixels are hashed.
+	 *
+	 * @param value bitmap, can be null
+	 * @return this state
+	 */
+	DrawState& Add(const BitmapRef& value);
+
+	/** @return signature over all added properties */
+	uint64_t GetSignature() const;
+
+private:
+	DrawState& Mix(uint64_t value);
+
+	uint64_t signature = 14695981039346656037ULL;
+};
+
 /**
  * Drawable virtual
  */
@@ -70,6 +133,33 @@ public:
 
 	virtual bool IsGlobal() const { return false; }
 
+	/**
+	 * Describes what the next Draw call renders.
+	 * Drawables not overriding this are assumed to change every frame and
+	 * cause a redraw of the whole screen.
+	 *
+	 * @param state receives the covered screen area and the signature
+	 * @return whether the drawable supports damage tracking
+	 */
+	virtual bool GetDrawState(DrawState& state);
+
+	/**
+	 * Adds the screen areas that must be redrawn because the drawable
+	 * changed since the last frame. Called by Graphics once per frame.
+	 *
+	 * @param damage list receiving the changed screen areas
+	 * @return false when the whole screen must be redrawn
+	 */
+	virtual bool UpdateDamage(std::vector<Rect>& damage);
+
+	/**
+	 * Gets the screen area covered by the drawable in the last frame.
+	 *
+	 * @param rect receives the screen area
+	 * @return false when unknown because the drawable does not track damage
+	 */
+	bool GetLastDrawRect(Rect& rect) const;
+
 	/**
 	 * Converts a RPG Maker map layer value into a EasyRPG priority value.
 	 *
@@ -83,6 +173,23 @@ public:
 	 * @return Priority or 0 when not found
 	 */
 	static int GetPriorityForBattleLayer(int which);
+
+	/**
+	 * Sort key of the drawable in the drawable list.
+	 * Managed by Graphics, drawables must not modify it.
+	 */
+	struct ListKey {
+		/** Z value the drawable is sorted by */
+		int z = 0;
+		/** Order of drawables with equal Z, assigned on registration and Z changes */
+		int64_t sequence = 0;
+	};
+	ListKey list_key;
+
+private:
+	DrawState last_draw_state;
+	bool last_draw_state_valid = false;
+	bool damage_untracked = false;
 };
 
 #endif
@@ -27,6 +27,7 @@
 #include <map>
 
 #include "dynrpg_particle.h"
+#include "dynrpg_pathfinder.h"
 #include "dynrpg_pec.h"
 #include "dynrpg_textplugin.h"
 #include "dynrpg_rpgss.h"
@@ -292,6 +293,7 @@ void create_all_plugins() {
 	plugins.emplace_back(new DynRpg::Pec());
 	plugins.emplace_back(new DynRpg::Particle());
 	plugins.emplace_back(new DynRpg::Rpgss());
+	plugins.emplace_back(new DynRpg::Pathfinder());
 
 	for (auto& plugin : plugins) {
 		plugin->RegisterFunctions();
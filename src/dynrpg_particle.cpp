@@ -83,10 +83,9 @@ public:
 
 	void SetZ(int z) {
 		if (z != this->z) {
-			Graphics::UpdateZCallback();
+			this->z = z;
+			Graphics::UpdateZCallback(this);
 		}
-
-		this->z = z;
 	}
 
 	DrawableType GetType() const {
@@ -0,0 +1,142 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "dynrpg_pathfinder.h"
+#include "game_event.h"
+#include "game_map.h"
+#include "picojson.h"
+
+static Game_Event* GetEvent(const std::string& func_name, int event_id) {
+	Game_Event* ev = Game_Map::GetEvent(event_id);
+	if (!ev) {
+		Output::Warning("%s: Invalid event ID %d", func_name.c_str(), event_id);
+	}
+	return ev;
+}
+
+static bool MoveTo(const dyn_arg_list& args) {
+	DYNRPG_FUNCTION("path_move_to")
+
+	DYNRPG_CHECK_ARG_LENGTH(3)
+
+	DYNRPG_GET_INT_ARG(0, event_id)
+	DYNRPG_GET_INT_ARG(1, x)
+	DYNRPG_GET_INT_ARG(2, y)
+
+	Game_Event* ev = GetEvent(func_name, event_id);
+	if (ev) {
+		ev->SetPathTarget(x, y);
+	}
+
+	return true;
+}
+
+static bool ChaseHero(const dyn_arg_list& args) {
+	DYNRPG_FUNCTION("path_chase_hero")
+
+	DYNRPG_CHECK_ARG_LENGTH(1)
+
+	DYNRPG_GET_INT_ARG(0, event_id)
+
+	Game_Event* ev = GetEvent(func_name, event_id);
+	if (ev) {
+		ev->SetPathTargetHero();
+	}
+
+	return true;
+}
+
+static bool Stop(const dyn_arg_list& args) {
+	DYNRPG_FUNCTION("path_stop")
+
+	DYNRPG_CHECK_ARG_LENGTH(1)
+
+	DYNRPG_GET_INT_ARG(0, event_id)
+
+	Game_Event* ev = GetEvent(func_name, event_id);
+	if (ev) {
+		ev->ClearPathTarget();
+	}
+
+	return true;
+}
+
+std::string DynRpg::Pathfinder::GetIdentifier() {
+	return "EasyRpgPathfinder";
+}
+
+void DynRpg::Pathfinder::RegisterFunctions() {
+	DynRpg::RegisterFunction("path_move_to", MoveTo);
+	DynRpg::RegisterFunction("path_chase_hero", ChaseHero);
+	DynRpg::RegisterFunction("path_stop", Stop);
+}
+
+void DynRpg::Pathfinder::Load(const std::vector<uint8_t>& in) {
+	picojson::value v;
+	std::string s(in.begin(), in.end());
+
+	picojson::parse(v, s);
+	if (!v.is<picojson::array>()) {
+		return;
+	}
+
+	for (auto& entry : v.get<picojson::array>()) {
+		if (!entry.is<picojson::object>()) {
+			continue;
+		}
+		auto& o = entry.get<picojson::object>();
+
+		// Skip malformed entries instead of failing the whole save
+		if (!o["id"].is<double>() || !o["hero"].is<bool>() ||
+			!o["x"].is<double>() || !o["y"].is<double>()) {
+			continue;
+		}
+
+		Game_Event* ev = Game_Map::GetEvent((int)o["id"].get<double>());
+		if (!ev) {
+			continue;
+		}
+
+		if (o["hero"].get<bool>()) {
+			ev->SetPathTargetHero();
+		} else {
+			ev->SetPathTarget((int)o["x"].get<double>(), (int)o["y"].get<double>());
+		}
+	}
+}
+
+std::vector<uint8_t> DynRpg::Pathfinder::Save() {
+	picojson::array a;
+
+	for (auto& ev : Game_Map::GetEvents()) {
+		if (!ev.HasPathTarget()) {
+			continue;
+		}
+
+		picojson::object o;
+		o["id"] = picojson::value((double)ev.GetId());
+		o["hero"] = picojson::value(ev.IsPathTargetHero());
+		o["x"] = picojson::value((double)ev.GetPathTargetX());
+		o["y"] = picojson::value((double)ev.GetPathTargetY());
+		a.push_back(picojson::value(o));
+	}
+
+	std::string s = picojson::value(a).serialize();
+
+	return std::vector<uint8_t>(s.begin(), s.end());
+}
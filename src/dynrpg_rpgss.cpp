@@ -413,10 +413,7 @@ public:
 	}
 
 	void SetZ(int z) {
-		if (z != this->z) {
-			Graphics::UpdateZCallback();
-		}
-
+		// Applied to the sprite in Update
 		this->z = z;
 	}
 
@@ -134,7 +134,7 @@ public:
 			if (sprite) {
 				if (z != sprite->GetZ()) {
 					z = sprite->GetZ() + 1;
-					Graphics::UpdateZCallback();
+					Graphics::UpdateZCallback(this);
 				}
 			}
 		}
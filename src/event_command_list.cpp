@@ -0,0 +1,207 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include <cassert>
+#include "event_command_list.h"
+#include "command_codes.h"
+#include "player.h"
+#include "reader_util.h"
+
+namespace {
+	using param_iterator = std::vector<int32_t>::const_iterator;
+
+	int DecodeInt(param_iterator& it, param_iterator end) {
+		int value = 0;
+
+		while (it != end) {
+			int x = *it++;
+			value <<= 7;
+			value |= x & 0x7F;
+			if (!(x & 0x80))
+				break;
+		}
+
+		return value;
+	}
+
+	std::string DecodeString(param_iterator& it, param_iterator end) {
+		int len = DecodeInt(it, end);
+
+		std::string out;
+		for (int i = 0; i < len && it != end; i++)
+			out.push_back(static_cast<char>(*it++));
+
+		return ReaderUtil::Recode(out, Player::encoding);
+	}
+
+	RPG::MoveCommand DecodeMove(param_iterator& it, param_iterator end) {
+		RPG::MoveCommand cmd;
+		cmd.command_id = *it++;
+
+		switch (cmd.command_id) {
+		case 32:	// Switch ON
+		case 33:	// Switch OFF
+			cmd.parameter_a = DecodeInt(it, end);
+			break;
+		case 34:	// Change Graphic
+			cmd.parameter_string = DecodeString(it, end);
+			cmd.parameter_a = DecodeInt(it, end);
+			break;
+		case 35:	// Play Sound Effect
+			cmd.parameter_string = DecodeString(it, end);
+			cmd.parameter_a = DecodeInt(it, end);
+			cmd.parameter_b = DecodeInt(it, end);
+			cmd.parameter_c = DecodeInt(it, end);
+			break;
+		}
+
+		return cmd;
+	}
+}
+
+constexpr int32_t EventCommandList::jump_none;
+constexpr int32_t EventCommandList::jump_blocked;
+
+EventCommandList::EventCommandList(std::vector<RPG::EventCommand> commands) :
+	commands(std::move(commands)) {
+	BuildIndex();
+}
+
+EventCommandListRef EventCommandList::Create(std::vector<RPG::EventCommand> commands) {
+	return std::make_shared<const EventCommandList>(std::move(commands));
+}
+
+const EventCommandListRef& EventCommandList::GetEmpty() {
+	static const EventCommandListRef empty = Create({});
+	return empty;
+}
+
+int32_t EventCommandList::Find(size_t start, int code, int code2, int min_indent, int max_indent) const {
+	size_t idx = start;
+	while (idx < commands.size()) {
+		const RPG::EventCommand& com = commands[idx];
+		if (com.indent < min_indent) {
+			return jump_blocked;
+		}
+		if (com.indent <= max_indent && (com.code == code || com.code == code2)) {
+			return static_cast<int32_t>(idx);
+		}
+		if (com.indent >= max_indent && max_indent >= min_indent) {
+			// All commands until the block end are nested deeper than max_indent
+			idx = block_end[idx];
+		} else {
+			++idx;
+		}
+	}
+
+	return static_cast<int32_t>(commands.size());
+}
+
+int32_t EventCommandList::GetLabel(int label_id) const {
+	auto it = labels.find(label_id);
+	return it != labels.end() ? it->second : jump_none;
+}
+
+const RPG::MoveRoute& EventCommandList::GetMoveRoute(size_t index) const {
+	auto it = move_routes.find(static_cast<int32_t>(index));
+	assert(it != move_routes.end());
+	return it->second;
+}
+
+RPG::MoveRoute EventCommandList::DecodeMoveRoute(const RPG::EventCommand& com) {
+	RPG::MoveRoute route;
+
+	if (com.parameters.size() < 4) {
+		return route;
+	}
+
+	route.repeat = com.parameters[2] != 0;
+	route.skippable = com.parameters[3] != 0;
+
+	param_iterator it = com.parameters.begin() + 4;
+	while (it < com.parameters.end()) {
+		route.move_commands.push_back(DecodeMove(it, com.parameters.end()));
+	}
+
+	return route;
+}
+
+void EventCommandList::BuildIndex() {
+	const int32_t size = static_cast<int32_t>(commands.size());
+
+	block_end.resize(size);
+	jumps.resize(size, jump_none);
+
+	// Next command with the same or a lower indent (monotonic stack)
+	std::vector<int32_t> stack;
+	for (int32_t i = size - 1; i >= 0; --i) {
+		while (!stack.empty() && commands[stack.back()].indent > commands[i].indent) {
+			stack.pop_back();
+		}
+		block_end[i] = stack.empty() ? size : stack.back();
+		stack.push_back(i);
+	}
+
+	// Previous command with a lower indent and last Loop of each indent.
+	// EndLoop jumps back to the last Loop of its indent when no command
+	// with a lower indent is in between.
+	stack.clear();
+	std::unordered_map<int, int32_t> last_loop;
+	for (int32_t i = 0; i < size; ++i) {
+		const RPG::EventCommand& com = commands[i];
+
+		while (!stack.empty() && commands[stack.back()].indent >= com.indent) {
+			stack.pop_back();
+		}
+		int32_t lower = stack.empty() ? -1 : stack.back();
+		stack.push_back(i);
+
+		switch (com.code) {
+			case Cmd::Loop:
+				last_loop[com.indent] = i;
+				break;
+			case Cmd::EndLoop: {
+				auto it = last_loop.find(com.indent);
+				if (it != last_loop.end() && it->second > lower) {
+					jumps[i] = it->second;
+				} else {
+					jumps[i] = lower >= 0 ? jump_blocked : jump_none;
+				}
+				break;
+			}
+			case Cmd::BreakLoop: {
+				int max_indent = com.indent - 1;
+				if (max_indent < 0) {
+					max_indent = com.indent;
+				}
+				jumps[i] = Find(i, Cmd::EndLoop, Cmd::EndLoop, 0, max_indent);
+				break;
+			}
+			case Cmd::Label:
+				if (!com.parameters.empty()) {
+					labels.emplace(com.parameters[0], i);
+				}
+				break;
+			case Cmd::MoveEvent:
+				move_routes.emplace(i, DecodeMoveRoute(com));
+				break;
+			default:
+				break;
+		}
+	}
+}
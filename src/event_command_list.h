@@ -0,0 +1,163 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_EVENT_COMMAND_LIST_H
+#define EP_EVENT_COMMAND_LIST_H
+
+// Headers
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "memory_management.h"
+#include "rpg_eventcommand.h"
+#include "rpg_moveroute.h"
+
+/**
+ * Immutable list of event commands shared by all interpreters running it.
+ * Starting an event only copies a reference instead of all commands.
+ *
+ * The branch, loop and label structure is indexed once on creation, this
+ * way the interpreter navigates the list without scanning it.
+ * Move routes encoded in the parameters are decoded once on creation, too.
+ */
+class EventCommandList {
+public:
+	/**
+	 * Creates a shared command list.
+	 *
+	 * @param commands event commands, copied once
+	 * @return shared command list
+	 */
+	static EventCommandListRef Create(std::vector<RPG::EventCommand> commands);
+
+	/** @return shared list without commands */
+	static const EventCommandListRef& GetEmpty();
+
+	explicit EventCommandList(std::vector<RPG::EventCommand> commands);
+
+	/** @return all commands, e.g. for storing them in a savegame */
+	const std::vector<RPG::EventCommand>& GetCommands() const;
+
+	/** @return number of commands */
+	size_t size() const;
+
+	/** @return whether the list contains no commands */
+	bool empty() const;
+
+	const RPG::EventCommand& operator[](size_t index) const;
+
+	/** Jump target when no matching command exists */
+	static constexpr int32_t jump_none = -1;
+	/** Jump target when the search was stopped by a command of a lower indent */
+	static constexpr int32_t jump_blocked = -2;
+
+	/**
+	 * Searches forward for a command with one of the passed codes.
+	 * Commands nested deeper than max_indent are skipped and a command with
+	 * an indent lower than min_indent stops the search.
+	 *
+	 * @param start index of the first command to check
+	 * @param code code to search
+	 * @param code2 alternative code to search
+	 * @param min_indent lowest indent which is searched
+	 * @param max_indent highest indent which is searched
+	 * @return index of the command, size() when the end was reached or
+	 *         jump_blocked
+	 */
+	int32_t Find(size_t start, int code, int code2, int min_indent, int max_indent) const;
+
+	/**
+	 * Gets the EndLoop a BreakLoop command jumps to.
+	 *
+	 * @param index index of a BreakLoop command
+	 * @return index of the EndLoop or size() when there is none
+	 */
+	int32_t GetBreakLoopTarget(size_t index) const;
+
+	/**
+	 * Gets the Loop an EndLoop command jumps back to.
+	 *
+	 * @param index index of an EndLoop command
+	 * @return index of the Loop, jump_none or jump_blocked
+	 */
+	int32_t GetEndLoopTarget(size_t index) const;
+
+	/**
+	 * Gets the first Label command with the passed ID.
+	 *
+	 * @param label_id label ID
+	 * @return index of the Label or jump_none
+	 */
+	int32_t GetLabel(int label_id) const;
+
+	/**
+	 * Gets the decoded move route of a MoveEvent command.
+	 *
+	 * @param index index of a MoveEvent command
+	 * @return move route
+	 */
+	const RPG::MoveRoute& GetMoveRoute(size_t index) const;
+
+	/**
+	 * Decodes the move route stored in the parameters of a MoveEvent command.
+	 * Strings are converted from the game encoding.
+	 *
+	 * @param com MoveEvent command
+	 * @return move route
+	 */
+	static RPG::MoveRoute DecodeMoveRoute(const RPG::EventCommand& com);
+
+private:
+	void BuildIndex();
+
+	std::vector<RPG::EventCommand> commands;
+
+	/** Index of the next command with the same or a lower indent */
+	std::vector<int32_t> block_end;
+	/** Jump targets of BreakLoop and EndLoop commands */
+	std::vector<int32_t> jumps;
+	/** First Label command for each label ID */
+	std::unordered_map<int, int32_t> labels;
+	/** Decoded move routes of MoveEvent commands */
+	std::unordered_map<int32_t, RPG::MoveRoute> move_routes;
+};
+
+inline const std::vector<RPG::EventCommand>& EventCommandList::GetCommands() const {
+	return commands;
+}
+
+inline size_t EventCommandList::size() const {
+	return commands.size();
+}
+
+inline bool EventCommandList::empty() const {
+	return commands.empty();
+}
+
+inline const RPG::EventCommand& EventCommandList::operator[](size_t index) const {
+	return commands[index];
+}
+
+inline int32_t EventCommandList::GetBreakLoopTarget(size_t index) const {
+	return jumps[index];
+}
+
+inline int32_t EventCommandList::GetEndLoopTarget(size_t index) const {
+	return jumps[index];
+}
+
+#endif
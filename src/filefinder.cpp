@@ -941,6 +941,21 @@ EasyRPG_Offset FileFinder::GetFileSize(const std::string& file) {
 	return (result == 0) ? sb.st_size : -1;
 }
 
+int64_t FileFinder::GetFileModificationTime(const std::string& file) {
+	StatBuf sb;
+	int result = GetStat(file.c_str(), &sb);
+	if (result != 0) {
+		return -1;
+	}
+#ifdef PSP2
+	// SceDateTime, only compared for equality
+	const auto& t = sb.st_mtime;
+	return ((((static_cast<int64_t>(t.year) * 12 + t.month) * 31 + t.day) * 24 + t.hour) * 60 + t.minute) * 60 + t.second;
+#else
+	return static_cast<int64_t>(sb.st_mtime);
+#endif
+}
+
 bool FileFinder::IsMajorUpdatedTree() {
 	EasyRPG_Offset size;
 
@@ -22,6 +22,7 @@
 #include "system.h"
 
 #include <string>
+#include <cstdint>
 #include <cstdio>
 #include <ios>
 #include <unordered_map>
@@ -301,6 +302,13 @@ namespace FileFinder {
 	 */
 	EasyRPG_Offset GetFileSize(const std::string& file);
 
+	/** Get the modification time of a file
+	 *
+	 * @param file the path to a file
+	 * @return the modification time, or -1 on error
+	 */
+	int64_t GetFileModificationTime(const std::string& file);
+
 	/**
 	 * Known file sizes
 	 */
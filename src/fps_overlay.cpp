@@ -15,7 +15,10 @@
  * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <cstdio>
 #include <sstream>
+#include <vector>
 
 #include "fps_overlay.h"
 #include "player.h"
@@ -76,6 +79,12 @@ void FpsOverlay::Draw() {
 		DisplayUi->GetDisplaySurface()->Blit(1, 2, *fps_bitmap, fps_rect, 255);
 	}
 
+#ifdef ENABLE_PROFILER
+	if (Player::profile_flag) {
+		DrawProfile();
+	}
+#endif
+
 	// Always drawn when speedup is on independent of FPS
 	if (last_speed_mod > 1) {
 		if (speedup_dirty) {
@@ -101,6 +110,49 @@ void FpsOverlay::Draw() {
 	}
 }
 
+bool FpsOverlay::GetDrawState(DrawState& state) {
+	bool fps_draw = (
+#ifndef EMSCRIPTEN
+		DisplayUi->IsFullscreen() &&
+#endif
+		Player::fps_flag);
+	bool speedup_draw = last_speed_mod > 1;
+	bool profile_draw = false;
+	bool dirty = (fps_draw && fps_dirty) || (speedup_draw && speedup_dirty);
+#ifdef ENABLE_PROFILER
+	profile_draw = Player::profile_flag;
+	dirty = dirty || (profile_draw && profile_dirty);
+#endif
+
+	if (dirty) {
+		// The text is rendered in Draw, the size is not known yet
+		state.rect = DisplayUi->GetDisplaySurface()->GetRect();
+		return true;
+	}
+
+	if (fps_draw) {
+		state.Cover(Rect(1, 2, fps_rect.width, fps_rect.height));
+		state.Add(fps_bitmap);
+	}
+
+	if (speedup_draw) {
+		int dwidth = DisplayUi->GetDisplaySurface()->GetWidth();
+		state.Cover(Rect(dwidth - speedup_rect.width - 1, 2, speedup_rect.width, speedup_rect.height));
+		state.Add(speedup_bitmap);
+	}
+
+#ifdef ENABLE_PROFILER
+	if (profile_draw && profile_bitmap) {
+		int y = fps_rect.height > 0 ? fps_rect.height + 4 : 2;
+		state.Cover(Rect(1, y, profile_bitmap->GetWidth(), profile_bitmap->GetHeight()));
+		state.Add(profile_bitmap);
+	}
+#endif
+
+	state.Add(fps_draw).Add(speedup_draw).Add(profile_draw);
+	return true;
+}
+
 int FpsOverlay::GetZ() const {
 	return z;
 }
@@ -133,6 +185,11 @@ void FpsOverlay::ResetCounter() {
 	ups = 0;
 
 	fps_dirty = true;
+
+#ifdef ENABLE_PROFILER
+	zone_averages = Profiler::TakeZoneTimes();
+	profile_dirty = true;
+#endif
 }
 
 std::string FpsOverlay::GetFpsString() const {
@@ -140,3 +197,40 @@ std::string FpsOverlay::GetFpsString() const {
 	text << "FPS: " << GetFps();
 	return text.str();
 }
+
+#ifdef ENABLE_PROFILER
+void FpsOverlay::DrawProfile() {
+	if (profile_dirty) {
+		std::vector<std::string> lines;
+		int width = 0;
+		int line_height = 0;
+
+		for (int i = 0; i < Profiler::Zone_Count; ++i) {
+			char buf[32];
+			snprintf(buf, sizeof(buf), " %6.3f ms", zone_averages[i] / 1000.0);
+			lines.push_back(std::string(Profiler::GetZoneName(static_cast<Profiler::Zone>(i))) + buf);
+
+			Rect rect = Font::Default()->GetSize(lines.back());
+			width = std::max(width, rect.width + 1);
+			line_height = std::max(line_height, rect.height);
+		}
+
+		int height = line_height * static_cast<int>(lines.size());
+		if (!profile_bitmap || profile_bitmap->GetWidth() < width || profile_bitmap->GetHeight() < height) {
+			profile_bitmap = Bitmap::Create(width, height, true);
+		}
+		profile_bitmap->Clear();
+		profile_bitmap->Fill(Color(0, 0, 0, 128));
+
+		for (size_t i = 0; i < lines.size(); ++i) {
+			profile_bitmap->TextDraw(1, i * line_height, Color(255, 255, 255, 255), lines[i]);
+		}
+
+		profile_dirty = false;
+	}
+
+	// Below the FPS counter
+	int y = fps_rect.height > 0 ? fps_rect.height + 4 : 2;
+	DisplayUi->GetDisplaySurface()->Blit(1, y, *profile_bitmap, profile_bitmap->GetRect(), 255);
+}
+#endif
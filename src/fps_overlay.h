@@ -22,11 +22,14 @@
 #include <string>
 #include "drawable.h"
 #include "memory_management.h"
+#include "profiler.h"
 #include "rect.h"
 
 /**
  * FpsOverlay class.
  * Shows current FPS and the speedup indicator.
+ * In profiler builds also the average time per frame spent in each
+ * profiler zone.
  */
 class FpsOverlay : public Drawable {
 public:
@@ -35,6 +38,8 @@ public:
 
 	void Draw() override;
 
+	bool GetDrawState(DrawState& state) override;
+
 	int GetZ() const override;
 
 	DrawableType GetType() const override;
@@ -80,6 +85,16 @@ public:
 	std::string GetFpsString() const;
 
 private:
+#ifdef ENABLE_PROFILER
+	void DrawProfile();
+
+	BitmapRef profile_bitmap;
+	bool profile_dirty = false;
+
+	/** Average time of one pass through each zone (us) */
+	Profiler::ZoneTimes zone_averages = {};
+#endif
+
 	DrawableType type;
 
 	BitmapRef fps_bitmap;
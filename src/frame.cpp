@@ -59,6 +59,14 @@ void Frame::Draw() {
 	}
 }
 
+bool Frame::GetDrawState(DrawState& state) {
+	if (frame_bitmap) {
+		state.rect = frame_bitmap->GetRect();
+		state.Add(frame_bitmap);
+	}
+	return true;
+}
+
 void Frame::OnFrameGraphicReady(FileRequestResult* result) {
 	frame_bitmap = Cache::Frame(result->file);
 }
@@ -58,6 +58,8 @@ namespace {
 	int target_enemy_index;
 	bool need_refresh;
 	std::vector<bool> page_can_run;
+	// Shared command lists of the troop pages, created on first run
+	std::vector<EventCommandListRef> page_lists;
 
 	std::function<bool(const RPG::TroopPage&)> last_event_filter;
 }
@@ -80,6 +82,8 @@ void Game_Battle::Init() {
 	std::fill(page_executed.begin(), page_executed.end(), false);
 	page_can_run.resize(troop->pages.size());
 	std::fill(page_can_run.begin(), page_can_run.end(), false);
+	page_lists.clear();
+	page_lists.resize(troop->pages.size());
 
 	RefreshEvents([](const RPG::TroopPage&) {
 		return false;
@@ -120,6 +124,7 @@ void Game_Battle::Quit() {
 
 	page_executed.clear();
 	page_can_run.clear();
+	page_lists.clear();
 
 	Main_Data::game_party->ResetBattle();
 }
@@ -373,7 +378,11 @@ bool Game_Battle::UpdateEvents() {
 
 	for (const auto& page : troop->pages) {
 		if (page_can_run[page.ID - 1]) {
-			interpreter->Setup(page.event_commands, 0);
+			EventCommandListRef& list = page_lists[page.ID - 1];
+			if (!list) {
+				list = EventCommandList::Create(page.event_commands);
+			}
+			interpreter->Setup(list, 0);
 			page_can_run[page.ID - 1] = false;
 			page_executed[page.ID - 1] = true;
 			return false;
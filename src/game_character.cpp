@@ -18,6 +18,7 @@
 // Headers
 #include "audio.h"
 #include "game_character.h"
+#include "game_event.h"
 #include "game_map.h"
 #include "game_player.h"
 #include "game_switches.h"
@@ -45,6 +46,20 @@ Game_Character::~Game_Character() {
 	Game_Map::RemovePendingMove(this);
 }
 
+void Game_Character::SetX(int new_x) {
+	data()->position_x = new_x;
+	if (GetType() == Event) {
+		Game_Map::UpdateEventPosition(static_cast<const Game_Event&>(*this));
+	}
+}
+
+void Game_Character::SetY(int new_y) {
+	data()->position_y = new_y;
+	if (GetType() == Event) {
+		Game_Map::UpdateEventPosition(static_cast<const Game_Event&>(*this));
+	}
+}
+
 bool Game_Character::MakeWay(int x, int y) const {
 	return Game_Map::MakeWay(*this, x, y);
 }
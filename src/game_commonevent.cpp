@@ -75,8 +75,11 @@ int Game_CommonEvent::GetTrigger() const {
 	return ReaderUtil::GetElement(Data::commonevents, common_event_id)->trigger;
 }
 
-std::vector<RPG::EventCommand>& Game_CommonEvent::GetList() {
-	return ReaderUtil::GetElement(Data::commonevents, common_event_id)->event_commands;
+const EventCommandListRef& Game_CommonEvent::GetList() {
+	if (!list) {
+		list = EventCommandList::Create(ReaderUtil::GetElement(Data::commonevents, common_event_id)->event_commands);
+	}
+	return list;
 }
 
 RPG::SaveEventExecState Game_CommonEvent::GetSaveData() {
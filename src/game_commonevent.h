@@ -91,10 +91,11 @@ public:
 
 	/**
 	 * Gets event commands list.
+	 * Created on first use and reused by all interpreters running the event.
 	 *
 	 * @return event commands list.
 	 */
-	std::vector<RPG::EventCommand>& GetList();
+	const EventCommandListRef& GetList();
 
 	RPG::SaveEventExecState GetSaveData();
 
@@ -109,6 +110,9 @@ private:
 
 	int common_event_id;
 
+	/** Shared event commands list */
+	EventCommandListRef list;
+
 	/** Interpreter for parallel common events. */
 	std::unique_ptr<Game_Interpreter_Map> interpreter;
 };
@@ -20,6 +20,7 @@
 #include "game_actor.h"
 #include "game_actors.h"
 #include "game_map.h"
+#include "game_pathfinder.h"
 #include "game_message.h"
 #include "game_party.h"
 #include "game_player.h"
@@ -30,6 +31,7 @@
 #include "main_data.h"
 #include "player.h"
 #include "utils.h"
+#include <cassert>
 #include <cmath>
 
 Game_Event::Game_Event(int map_id, const RPG::Event& event) :
@@ -98,7 +100,7 @@ void Game_Event::Setup(const RPG::EventPage* new_page) {
 		SetSpriteIndex(0);
 		SetDirection(RPG::EventPage::Direction_down);
 		trigger = -1;
-		list.clear();
+		list = EventCommandList::GetEmpty();
 		return;
 	}
 
@@ -136,7 +138,7 @@ void Game_Event::Setup(const RPG::EventPage* new_page) {
 	SetLayer(page->layer);
 	data()->overlap_forbidden = page->overlap_forbidden;
 	trigger = page->trigger;
-	list = page->event_commands;
+	list = GetPageList(*page);
 
 	if (trigger == RPG::EventPage::Trigger_parallel) {
 		interpreter.reset(new Game_Interpreter_Map());
@@ -148,14 +150,14 @@ void Game_Event::SetupFromSave(const RPG::EventPage* new_page) {
 
 	if (page == nullptr) {
 		trigger = -1;
-		list.clear();
+		list = EventCommandList::GetEmpty();
 		interpreter.reset();
 		return;
 	}
 
 	original_move_frequency = page->move_frequency;
 	trigger = page->trigger;
-	list = page->event_commands;
+	list = GetPageList(*page);
 
 	// Trigger parallel events when the interpreter wasn't already running
 	// (because it was the middle of a parallel event while saving)
@@ -302,7 +304,7 @@ RPG::EventPage::Trigger Game_Event::GetTrigger() const {
 
 bool Game_Event::SetAsWaitingForegroundExecution(bool face_hero, bool by_decision_key) {
 	// RGSS scripts consider list empty if size <= 1. Why?
-	if (list.empty() || !data()->active) {
+	if (list->empty() || !data()->active) {
 		return false;
 	}
 
@@ -317,10 +319,25 @@ bool Game_Event::SetAsWaitingForegroundExecution(bool face_hero, bool by_decisio
 	return true;
 }
 
-const std::vector<RPG::EventCommand>& Game_Event::GetList() const {
+const EventCommandListRef& Game_Event::GetList() const {
 	return list;
 }
 
+const EventCommandListRef& Game_Event::GetPageList(const RPG::EventPage& page) {
+	size_t idx = &page - event.pages.data();
+	assert(idx < event.pages.size());
+
+	if (page_lists.size() != event.pages.size()) {
+		page_lists.resize(event.pages.size());
+	}
+
+	EventCommandListRef& page_list = page_lists[idx];
+	if (!page_list) {
+		page_list = EventCommandList::Create(page.event_commands);
+	}
+	return page_list;
+}
+
 void Game_Event::OnFinishForegroundEvent() {
 	if (!(IsDirectionFixed() || IsFacingLocked() || IsSpinning())) {
 		SetSpriteDirection(GetDirection());
@@ -381,6 +398,11 @@ void Game_Event::UpdateSelfMovement() {
 		return;
 	}
 
+	if (path_mode != PathNone) {
+		MoveTypePathfind();
+		return;
+	}
+
 	switch (page->move_type) {
 	case RPG::EventPage::MoveType_random:
 		MoveTypeRandom();
@@ -505,6 +527,73 @@ void Game_Event::MoveTypeAwayFromPlayer() {
 	MoveTypeTowardsOrAwayPlayer(false);
 }
 
+void Game_Event::MoveTypePathfind() {
+	int target_x = path_x;
+	int target_y = path_y;
+	if (path_mode == PathHero) {
+		target_x = Main_Data::game_player->GetX();
+		target_y = Main_Data::game_player->GetY();
+	}
+
+	if (IsInPosition(target_x, target_y)) {
+		if (path_mode == PathTile) {
+			ClearPathTarget();
+		}
+		return;
+	}
+
+	SetMaxStopCountForStep();
+	if (GetStopCount() < GetMaxStopCount()) return;
+
+	int dir = Game_Pathfinder::FindDirection(*this, target_x, target_y);
+	if (dir < 0) {
+		if (path_mode != PathHero) {
+			return;
+		}
+		// No way known (yet), approach the hero like "Move towards hero"
+		dir = GetDirectionToHero();
+	}
+
+	Move(dir, MoveOption::IgnoreIfCantMove);
+
+	if (move_failed) {
+		Game_Pathfinder::Invalidate(*this);
+	}
+}
+
+void Game_Event::SetPathTarget(int x, int y) {
+	path_mode = PathTile;
+	path_x = x;
+	path_y = y;
+	Game_Pathfinder::Invalidate(*this);
+}
+
+void Game_Event::SetPathTargetHero() {
+	path_mode = PathHero;
+	Game_Pathfinder::Invalidate(*this);
+}
+
+void Game_Event::ClearPathTarget() {
+	path_mode = PathNone;
+	Game_Pathfinder::Invalidate(*this);
+}
+
+bool Game_Event::HasPathTarget() const {
+	return path_mode != PathNone;
+}
+
+bool Game_Event::IsPathTargetHero() const {
+	return path_mode == PathHero;
+}
+
+int Game_Event::GetPathTargetX() const {
+	return path_x;
+}
+
+int Game_Event::GetPathTargetY() const {
+	return path_y;
+}
+
 void Game_Event::Update() {
 	if (!data()->active || page == NULL) {
 		return;
@@ -94,11 +94,20 @@ public:
 	RPG::EventPage::Trigger GetTrigger() const;
 
 	/**
-	 * Gets event commands list.
+	 * Gets event commands list of the active page.
 	 *
 	 * @return event commands list.
 	 */
-	const std::vector<RPG::EventCommand>& GetList() const;
+	const EventCommandListRef& GetList() const;
+
+	/**
+	 * Gets the shared event commands list of a page.
+	 * Created on first use and reused by all interpreters running the page.
+	 *
+	 * @param page page of this event
+	 * @return event commands list.
+	 */
+	const EventCommandListRef& GetPageList(const RPG::EventPage& page);
 
 	/**
 	 * Event returns to its original direction before talking to the hero.
@@ -145,6 +154,38 @@ public:
 	const RPG::EventPage* GetActivePage() const;
 
 	const RPG::SaveMapEvent& GetSaveData();
+
+	/**
+	 * Makes the event walk to a tile using the pathfinder instead of
+	 * its movement type. The target is cleared when the tile is reached.
+	 *
+	 * @param x target tile x
+	 * @param y target tile y
+	 */
+	void SetPathTarget(int x, int y);
+
+	/**
+	 * Makes the event chase the hero using the pathfinder instead of
+	 * its movement type.
+	 */
+	void SetPathTargetHero();
+
+	/**
+	 * Returns the event to its movement type.
+	 */
+	void ClearPathTarget();
+
+	/** @return whether the event walks to a pathfinder target */
+	bool HasPathTarget() const;
+
+	/** @return whether the event chases the hero with the pathfinder */
+	bool IsPathTargetHero() const;
+
+	/** @return pathfinder target tile x, unused when chasing the hero */
+	int GetPathTargetX() const;
+
+	/** @return pathfinder target tile y, unused when chasing the hero */
+	int GetPathTargetY() const;
 protected:
 	RPG::SaveMapEvent* data();
 	const RPG::SaveMapEvent* data() const;
@@ -193,6 +234,17 @@ private:
 	 */
 	void MoveTypeAwayFromPlayer();
 
+	/**
+	 * Walks one step along the pathfinder way to the path target.
+	 */
+	void MoveTypePathfind();
+
+	enum PathMode {
+		PathNone,
+		PathTile,
+		PathHero
+	};
+
 	// Not a reference on purpose.
 	// Events change during map change and old are destroyed, breaking the
 	// reference.
@@ -201,9 +253,14 @@ private:
 	int trigger = -1;
 	RPG::Event event;
 	const RPG::EventPage* page = nullptr;
-	std::vector<RPG::EventCommand> list;
+	EventCommandListRef list = EventCommandList::GetEmpty();
+	/** Shared command lists of the pages, indexed like event.pages */
+	std::vector<EventCommandListRef> page_lists;
 	std::shared_ptr<Game_Interpreter> interpreter;
 	bool from_save;
+	PathMode path_mode = PathNone;
+	int path_x = 0;
+	int path_y = 0;
 };
 
 inline RPG::SaveMapEvent* Game_Event::data() {
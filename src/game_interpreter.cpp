@@ -46,6 +46,7 @@
 #include "main_data.h"
 #include "output.h"
 #include "player.h"
+#include "profiler.h"
 #include "util_macro.h"
 #include "reader_util.h"
 #include "game_battle.h"
@@ -94,17 +95,17 @@ void Game_Interpreter::Clear() {
 		else
 			child_interpreter.reset();
 	}
-	list.clear();
+	list = EventCommandList::GetEmpty();
 }
 
 // Is interpreter running.
 bool Game_Interpreter::IsRunning() const {
-	return !list.empty();
+	return !list->empty();
 }
 
 // Setup.
 void Game_Interpreter::Setup(
-	const std::vector<RPG::EventCommand>& _list,
+	const EventCommandListRef& _list,
 	int _event_id,
 	bool started_by_decision_key
 ) {
@@ -153,6 +154,8 @@ bool Game_Interpreter::ReachedLoopLimit() const {
 
 // Update
 void Game_Interpreter::Update(bool reset_loop_count) {
+	EP_PROFILE_ZONE(Zone_InterpreterUpdate);
+
 	updating = true;
 	if (reset_loop_count) {
 		loop_count = 0;
@@ -221,10 +224,10 @@ void Game_Interpreter::Update(bool reset_loop_count) {
 
 		if (continuation) {
 			bool result;
-			if (index >= list.size()) {
+			if (index >= list->size()) {
 				result = (this->*continuation)(RPG::EventCommand());
 			} else {
-				result = (this->*continuation)(list[index]);
+				result = (this->*continuation)((*list)[index]);
 			}
 
 			if (result)
@@ -237,7 +240,7 @@ void Game_Interpreter::Update(bool reset_loop_count) {
 			Game_Map::Refresh();
 		}
 
-		if (list.empty()) {
+		if (list->empty()) {
 			break;
 		}
 
@@ -297,82 +300,23 @@ bool Game_Interpreter::SkipTo(int code, int code2, int min_indent, int max_inden
 	if (code2 < 0)
 		code2 = code;
 	if (min_indent < 0)
-		min_indent = list[index].indent;
+		min_indent = (*list)[index].indent;
 	if (max_indent < 0)
-		max_indent = list[index].indent;
+		max_indent = (*list)[index].indent;
 
-	int idx;
-	for (idx = index; (size_t) idx < list.size(); idx++) {
-		if (list[idx].indent < min_indent)
-			return false;
-		if (list[idx].indent > max_indent)
-			continue;
-		if (list[idx].code != code &&
-			list[idx].code != code2)
-			continue;
-		index = idx;
-		return true;
-	}
+	int idx = list->Find(index, code, code2, min_indent, max_indent);
+	if (idx == EventCommandList::jump_blocked)
+		return false;
 
-	if (otherwise_end)
+	if ((size_t) idx < list->size() || otherwise_end)
 		index = idx;
 
 	return true;
 }
 
-int Game_Interpreter::DecodeInt(std::vector<int32_t>::const_iterator& it) {
-	int value = 0;
-
-	for (;;) {
-		int x = *it++;
-		value <<= 7;
-		value |= x & 0x7F;
-		if (!(x & 0x80))
-			break;
-	}
-
-	return value;
-}
-
-const std::string Game_Interpreter::DecodeString(std::vector<int32_t>::const_iterator& it) {
-	std::ostringstream out;
-	int len = DecodeInt(it);
-
-	for (int i = 0; i < len; i++)
-		out << (char)*it++;
-
-	std::string result = ReaderUtil::Recode(out.str(), Player::encoding);
-
-	return result;
-}
-
-RPG::MoveCommand Game_Interpreter::DecodeMove(std::vector<int32_t>::const_iterator& it) {
-	RPG::MoveCommand cmd;
-	cmd.command_id = *it++;
-
-	switch (cmd.command_id) {
-	case 32:	// Switch ON
-	case 33:	// Switch OFF
-		cmd.parameter_a = DecodeInt(it);
-		break;
-	case 34:	// Change Graphic
-		cmd.parameter_string = DecodeString(it);
-		cmd.parameter_a = DecodeInt(it);
-		break;
-	case 35:	// Play Sound Effect
-		cmd.parameter_string = DecodeString(it);
-		cmd.parameter_a = DecodeInt(it);
-		cmd.parameter_b = DecodeInt(it);
-		cmd.parameter_c = DecodeInt(it);
-		break;
-	}
-
-	return cmd;
-}
-
 // Execute Command.
 bool Game_Interpreter::ExecuteCommand() {
-	RPG::EventCommand const& com = list[index];
+	RPG::EventCommand const& com = (*list)[index];
 
 	switch (com.code) {
 		case Cmd::ShowMessage:
@@ -440,8 +384,8 @@ bool Game_Interpreter::ExecuteCommand() {
 
 				std::string command = com.string;
 				// Concat everything that is not another command or a new comment block
-				for (size_t i = index + 1; i < list.size(); ++i) {
-					const RPG::EventCommand& cmd = list[i];
+				for (size_t i = index + 1; i < list->size(); ++i) {
+					const RPG::EventCommand& cmd = (*list)[i];
 					if (cmd.code == Cmd::Comment_2 && !cmd.string.empty() && cmd.string[0] != '@') {
 						command += cmd.string;
 					} else {
@@ -577,7 +521,7 @@ bool Game_Interpreter::CommandEnd() { // code 10
 	//	Game_Message::FullClear();
 	//}
 
-	list.clear();
+	list = EventCommandList::GetEmpty();
 
 	if (main_flag && depth == 0 && event_id > 0) {
 		Game_Event* evnt = Game_Map::GetEvent(event_id);
@@ -592,19 +536,19 @@ bool Game_Interpreter::CommandEnd() { // code 10
 
 std::vector<std::string> Game_Interpreter::GetChoices() {
 	// Let's find the choices
-	int current_indent = list[index + 1].indent;
+	int current_indent = (*list)[index + 1].indent;
 	std::vector<std::string> s_choices;
-	for (unsigned index_temp = index + 1; index_temp < list.size(); ++index_temp) {
-		if (list[index_temp].indent != current_indent) {
+	for (unsigned index_temp = index + 1; index_temp < list->size(); ++index_temp) {
+		if ((*list)[index_temp].indent != current_indent) {
 			continue;
 		}
 
-		if (list[index_temp].code == Cmd::ShowChoiceOption) {
+		if ((*list)[index_temp].code == Cmd::ShowChoiceOption) {
 			// Choice found
-			s_choices.push_back(list[index_temp].string);
+			s_choices.push_back((*list)[index_temp].string);
 		}
 
-		if (list[index_temp].code == Cmd::ShowChoiceEnd) {
+		if ((*list)[index_temp].code == Cmd::ShowChoiceEnd) {
 			// End of choices found
 			if (s_choices.size() > 1 && s_choices.back().empty()) {
 				// Remove cancel branch
@@ -635,31 +579,31 @@ bool Game_Interpreter::CommandShowMessage(RPG::EventCommand const& com) { // cod
 	Game_Message::texts.push_back(com.string);
 	line_count++;
 
-	for (; index + 1 < list.size(); index++) {
+	for (; index + 1 < list->size(); index++) {
 		// If next event command is the following parts of the message
-		if (list[index+1].code == Cmd::ShowMessage_2) {
+		if ((*list)[index+1].code == Cmd::ShowMessage_2) {
 			// Add second (another) line
 			line_count++;
-			Game_Message::texts.push_back(list[index+1].string);
+			Game_Message::texts.push_back((*list)[index+1].string);
 		} else {
 			// If next event command is show choices
-			if (list[index+1].code == Cmd::ShowChoice) {
+			if ((*list)[index+1].code == Cmd::ShowChoice) {
 				std::vector<std::string> s_choices = GetChoices();
 				// If choices fit on screen
 				if (s_choices.size() <= (4 - line_count)) {
 					index++;
 					Game_Message::choice_start = line_count;
-					Game_Message::choice_cancel_type = list[index].parameters[0];
+					Game_Message::choice_cancel_type = (*list)[index].parameters[0];
 					SetupChoices(s_choices);
 				}
-			} else if (list[index+1].code == Cmd::InputNumber) {
+			} else if ((*list)[index+1].code == Cmd::InputNumber) {
 				// If next event command is input number
 				// If input number fits on screen
 				if (line_count < 4) {
 					index++;
 					Game_Message::num_input_start = line_count;
-					Game_Message::num_input_digits_max = list[index].parameters[0];
-					Game_Message::num_input_variable_id = list[index].parameters[1];
+					Game_Message::num_input_digits_max = (*list)[index].parameters[0];
+					Game_Message::num_input_variable_id = (*list)[index].parameters[1];
 				}
 			}
 
@@ -709,7 +653,7 @@ bool Game_Interpreter::ContinuationChoices(RPG::EventCommand const& com) {
 	for (;;) {
 		if (!SkipTo(Cmd::ShowChoiceOption, Cmd::ShowChoiceEnd, indent, indent))
 			return false;
-		auto& cmd = list[index];
+		auto& cmd = (*list)[index];
 		if (cmd.code == Cmd::ShowChoiceEnd) {
 			return false;
 		}
@@ -1557,7 +1501,7 @@ bool Game_Interpreter::CommandPlaySound(RPG::EventCommand const& com) { // code
 }
 
 bool Game_Interpreter::CommandEndEventProcessing(RPG::EventCommand const& /* com */) { // code 12310
-	index = list.size();
+	index = list->size();
 	return true;
 }
 
@@ -2346,7 +2290,6 @@ bool Game_Interpreter::CommandMoveEvent(RPG::EventCommand const& com) { // code
 			if (static_cast<Game_Vehicle*>(event)->IsInUse())
 				event = Main_Data::game_player.get();
 
-		RPG::MoveRoute route;
 		int move_freq = com.parameters[1];
 
 		if (move_freq <= 0 || move_freq > 8) {
@@ -2354,12 +2297,14 @@ bool Game_Interpreter::CommandMoveEvent(RPG::EventCommand const& com) { // code
 			move_freq = 6;
 		}
 
-		route.repeat = com.parameters[2] != 0;
-		route.skippable = com.parameters[3] != 0;
-
-		std::vector<int32_t>::const_iterator it;
-		for (it = com.parameters.begin() + 4; it < com.parameters.end(); )
-			route.move_commands.push_back(DecodeMove(it));
+		// Decoded when the command list was created
+		const RPG::MoveRoute& route = list->GetMoveRoute(index);
+#ifdef EP_DEBUG_INTERPRETER
+		// Cross-check against decoding the parameters now
+		if (!(route == EventCommandList::DecodeMoveRoute(com))) {
+			Output::Warning("MoveEvent: Pre-decoded move route differs (event %d, command %u)", event_id, index);
+		}
+#endif
 
 		event->ForceMoveRoute(route, move_freq);
 	}
@@ -2808,37 +2753,30 @@ bool Game_Interpreter::CommandConditionalBranch(RPG::EventCommand const& com) {
 }
 
 bool Game_Interpreter::CommandJumpToLabel(RPG::EventCommand const& com) { // code 12120
-	int label_id = com.parameters[0];
-
-	for (int idx = 0; (size_t)idx < list.size(); idx++) {
-		if (list[idx].code != Cmd::Label)
-			continue;
-		if (list[idx].parameters[0] != label_id)
-			continue;
+	int idx = list->GetLabel(com.parameters[0]);
+	if (idx != EventCommandList::jump_none)
 		index = idx;
-		break;
-	}
 
 	return true;
 }
 
-bool Game_Interpreter::CommandBreakLoop(RPG::EventCommand const& com) { // code 12220
-	return SkipTo(Cmd::EndLoop, Cmd::EndLoop, 0, com.indent - 1, true);
+bool Game_Interpreter::CommandBreakLoop(RPG::EventCommand const& /* com */) { // code 12220
+	// Equivalent to SkipTo(Cmd::EndLoop, Cmd::EndLoop, 0, com.indent - 1, true)
+	int idx = list->GetBreakLoopTarget(index);
+	if (idx == EventCommandList::jump_blocked)
+		return false;
+
+	index = idx;
+	return true;
 }
 
-bool Game_Interpreter::CommandEndLoop(RPG::EventCommand const& com) { // code 22210
-	int indent = com.indent;
+bool Game_Interpreter::CommandEndLoop(RPG::EventCommand const& /* com */) { // code 22210
+	int idx = list->GetEndLoopTarget(index);
+	if (idx == EventCommandList::jump_blocked)
+		return false;
 
-	for (int idx = index; idx >= 0; idx--) {
-		if (list[idx].indent > indent)
-			continue;
-		if (list[idx].indent < indent)
-			return false;
-		if (list[idx].code != Cmd::Loop)
-			continue;
+	if (idx != EventCommandList::jump_none)
 		index = idx;
-		break;
-	}
 
 	return true;
 }
@@ -2913,7 +2851,7 @@ bool Game_Interpreter::CommandCallEvent(RPG::EventCommand const& com) { // code
 	if (event) {
 		const RPG::EventPage* page = event->GetPage(event_page);
 		if (page) {
-			child_interpreter->Setup(page->event_commands, event->GetId(), false);
+			child_interpreter->Setup(event->GetPageList(*page), event->GetId(), false);
 			child_interpreter->event_info.x = event->GetX();
 			child_interpreter->event_info.y = event->GetY();
 			child_interpreter->event_info.page = page;
@@ -22,6 +22,7 @@
 #include <string>
 #include <vector>
 #include "async_handler.h"
+#include "event_command_list.h"
 #include "game_character.h"
 #include "game_actor.h"
 #include "rpg_eventcommand.h"
@@ -58,7 +59,7 @@ public:
 	bool IsRunningMapEvent() const;
 
 	void Setup(
-			const std::vector<RPG::EventCommand>& _list,
+			const EventCommandListRef& _list,
 			int _event_id,
 			bool started_by_decision_key = false
 	);
@@ -88,7 +89,8 @@ protected:
 	typedef bool (Game_Interpreter::*ContinuationFunction)(RPG::EventCommand const& com);
 	ContinuationFunction continuation;
 
-	std::vector<RPG::EventCommand> list;
+	/** Commands being executed, shared with the event and never null */
+	EventCommandListRef list;
 
 	int button_timer;
 	bool waiting_battle_anim;
@@ -224,10 +226,6 @@ protected:
 	virtual bool ContinuationShowInnFinish(RPG::EventCommand const& com);
 	virtual bool ContinuationEnemyEncounter(RPG::EventCommand const& com);
 
-	int DecodeInt(std::vector<int32_t>::const_iterator& it);
-	const std::string DecodeString(std::vector<int32_t>::const_iterator& it);
-	RPG::MoveCommand DecodeMove(std::vector<int32_t>::const_iterator& it);
-
 	void OnChangeSystemGraphicReady(FileRequestResult* result);
 
 	struct {
@@ -37,11 +37,11 @@ Game_Interpreter_Battle::Game_Interpreter_Battle(int depth, bool main_flag) :
 
 // Execute Command.
 bool Game_Interpreter_Battle::ExecuteCommand() {
-	if (index >= list.size()) {
+	if (index >= list->size()) {
 		return CommandEnd();
 	}
 
-	RPG::EventCommand const& com = list[index];
+	RPG::EventCommand const& com = (*list)[index];
 
 	switch (com.code) {
 		case Cmd::CallCommonEvent:
@@ -59,7 +59,7 @@ bool Game_Interpreter_Map::SetupFromSave(const std::vector<RPG::SaveEventExecFra
 			// When 0 the event is from a different map
 			map_id = Game_Map::GetMapId();
 		}
-		list = save[_index].commands;
+		list = EventCommandList::Create(save[_index].commands);
 		index = save[_index].current_command;
 		triggered_by_decision_key = save[_index].triggered_by_decision_key;
 
@@ -80,13 +80,13 @@ std::vector<RPG::SaveEventExecFrame> Game_Interpreter_Map::GetSaveData() const {
 
 	int i = 1;
 
-	if (save_interpreter->list.empty()) {
+	if (save_interpreter->list->empty()) {
 		return save;
 	}
 
 	while (save_interpreter != NULL) {
 		RPG::SaveEventExecFrame save_commands;
-		save_commands.commands = save_interpreter->list;
+		save_commands.commands = save_interpreter->list->GetCommands();
 		save_commands.current_command = save_interpreter->index;
 		save_commands.ID = i++;
 		save_commands.event_id = event_id;
@@ -102,11 +102,11 @@ std::vector<RPG::SaveEventExecFrame> Game_Interpreter_Map::GetSaveData() const {
  * Execute Command.
  */
 bool Game_Interpreter_Map::ExecuteCommand() {
-	if (index >= list.size()) {
+	if (index >= list->size()) {
 		return CommandEnd();
 	}
 
-	RPG::EventCommand const& com = list[index];
+	RPG::EventCommand const& com = (*list)[index];
 
 	switch (com.code) {
 		case Cmd::RecallToLocation:
@@ -21,6 +21,8 @@
 #include <sstream>
 #include <algorithm>
 #include <climits>
+#include <functional>
+#include <unordered_map>
 
 #include "async_handler.h"
 #include "system.h"
@@ -29,7 +31,9 @@
 #include "game_battler.h"
 #include "game_map.h"
 #include "game_interpreter_map.h"
+#include "game_pathfinder.h"
 #include "game_switches.h"
+#include "game_variables.h"
 #include "game_temp.h"
 #include "game_player.h"
 #include "game_party.h"
@@ -42,6 +46,7 @@
 #include "game_system.h"
 #include "filefinder.h"
 #include "player.h"
+#include "profiler.h"
 #include "input.h"
 #include "utils.h"
 #include "dynrpg.h"
@@ -64,9 +69,33 @@ namespace {
 
 	std::vector<unsigned char> passages_down;
 	std::vector<unsigned char> passages_up;
+
+	// Chipset passability of every tile after tile substitution.
+	// Low byte: Passable flags of the upper layer tile,
+	// high byte: Passable direction flags of the lower layer tile.
+	std::vector<uint16_t> tile_passages;
+	// Terrain ID of every tile after tile substitution
+	std::vector<int16_t> tile_terrain;
 	std::vector<Game_Event> events;
 	std::vector<Game_CommonEvent> common_events;
 
+	// Indices of the events with pages depending on a switch or variable
+	std::unordered_map<int, std::vector<int>> switch_refresh_index;
+	std::unordered_map<int, std::vector<int>> variable_refresh_index;
+	// Indices of the events with item, actor or timer conditions. These are
+	// not tracked and refreshed every time.
+	std::vector<int> always_refresh_events;
+	// Refresh all events instead of only the ones depending on changes
+	bool refresh_all_events = true;
+
+	// Spatial index of the events. The events on a tile form a linked list
+	// sorted by event index, events outside of the map share one list.
+	std::vector<int> event_tile_head;
+	int event_outside_head = -1;
+	// Per event: Next event on the same tile and the tile the event is linked to
+	std::vector<int> event_tile_next;
+	std::vector<int> event_tile;
+
 	std::unique_ptr<RPG::Map> map;
 
 	std::unique_ptr<Game_Interpreter_Map> interpreter;
@@ -90,6 +119,9 @@ namespace {
 }
 
 static Game_Map::Parallax::Params GetParallaxParams();
+static void BuildRefreshIndex();
+static void BuildEventIndex();
+static void BuildTileGrid();
 
 void Game_Map::Init() {
 	Dispose();
@@ -125,6 +157,13 @@ void Game_Map::Init() {
 
 void Game_Map::Dispose() {
 	events.clear();
+	Game_Pathfinder::Reset();
+	event_tile_head.clear();
+	event_outside_head = -1;
+	event_tile_next.clear();
+	event_tile.clear();
+	tile_passages.clear();
+	tile_terrain.clear();
 	pending.clear();
 
 	if (Main_Data::game_screen) {
@@ -155,8 +194,6 @@ void Game_Map::Setup(int _id) {
 
 	Parallax::ClearChangedBG();
 
-	SetChipset(map->chipset_id);
-
 	for (size_t i = 0; i < map_info.lower_tiles.size(); i++) {
 		map_info.lower_tiles[i] = i;
 	}
@@ -164,10 +201,14 @@ void Game_Map::Setup(int _id) {
 		map_info.upper_tiles[i] = i;
 	}
 
+	SetChipset(map->chipset_id);
+
 	events.reserve(map->events.size());
 	for (const RPG::Event& ev : map->events) {
 		events.emplace_back(location.map_id, ev);
 	}
+	BuildRefreshIndex();
+	BuildEventIndex();
 
 	// pan_state does not reset when you change maps.
 	location.pan_speed = default_pan_speed;
@@ -233,6 +274,8 @@ void Game_Map::SetupFromSave() {
 		if (events.back().IsMoveRouteOverwritten())
 			pending.push_back(&events.back());
 	}
+	BuildRefreshIndex();
+	BuildEventIndex();
 
 	for (size_t i = 0; i < Main_Data::game_data.common_events.size() && i < common_events.size(); ++i) {
 		common_events[i].SetSaveData(Main_Data::game_data.common_events[i].parallel_event_execstate);
@@ -389,11 +432,172 @@ void Game_Map::PlayBgm() {
 	}
 }
 
+static void BuildRefreshIndex() {
+	switch_refresh_index.clear();
+	variable_refresh_index.clear();
+	always_refresh_events.clear();
+	refresh_all_events = true;
+
+	auto add = [](std::vector<int>& list, int event_index) {
+		if (list.empty() || list.back() != event_index) {
+			list.push_back(event_index);
+		}
+	};
+
+	for (size_t i = 0; i < map->events.size(); ++i) {
+		int event_index = static_cast<int>(i);
+		for (const RPG::EventPage& page : map->events[i].pages) {
+			const auto& flags = page.condition.flags;
+			if (flags.switch_a) {
+				add(switch_refresh_index[page.condition.switch_a_id], event_index);
+			}
+			if (flags.switch_b) {
+				add(switch_refresh_index[page.condition.switch_b_id], event_index);
+			}
+			if (flags.variable) {
+				add(variable_refresh_index[page.condition.variable_id], event_index);
+			}
+			if (flags.item || flags.actor || flags.timer || flags.timer2) {
+				add(always_refresh_events, event_index);
+			}
+		}
+	}
+}
+
+/**
+ * Gets the tile an event is indexed under.
+ *
+ * @return tile index or -1 for positions outside the map
+ */
+static int GetEventTile(int x, int y) {
+	return Game_Map::IsValid(x, y) ? x + y * Game_Map::GetWidth() : -1;
+}
+
+/** First event on a tile, tile -1 holds the events outside the map */
+static int& GetEventTileHead(int tile) {
+	return tile < 0 ? event_outside_head : event_tile_head[tile];
+}
+
+/** Inserts an event into the list of its current tile, sorted by index. */
+static void LinkEvent(int index) {
+	const Game_Event& ev = events[index];
+	const int tile = GetEventTile(ev.GetX(), ev.GetY());
+
+	int* link = &GetEventTileHead(tile);
+	while (*link >= 0 && *link < index) {
+		link = &event_tile_next[*link];
+	}
+	event_tile_next[index] = *link;
+	event_tile[index] = tile;
+	*link = index;
+}
+
+/** Removes an event from the list of the tile it was indexed under. */
+static void UnlinkEvent(int index) {
+	int* link = &GetEventTileHead(event_tile[index]);
+	while (*link != index) {
+		link = &event_tile_next[*link];
+	}
+	*link = event_tile_next[index];
+	event_tile_next[index] = -1;
+}
+
+/** Rebuilds the spatial event index for all events of the map. */
+static void BuildEventIndex() {
+	event_tile_head.assign(Game_Map::GetWidth() * Game_Map::GetHeight(), -1);
+	event_outside_head = -1;
+	event_tile_next.assign(events.size(), -1);
+	event_tile.assign(events.size(), -1);
+
+	for (int i = static_cast<int>(events.size()) - 1; i >= 0; --i) {
+		LinkEvent(i);
+	}
+}
+
+/**
+ * Finds the next event at a position using the spatial event index.
+ * The position is checked at the time of the call, which keeps iteration
+ * valid when the visited events move.
+ *
+ * @param x tile x
+ * @param y tile y
+ * @param after index of the last visited event, -1 to start
+ * @return index of the event or -1 when there are no more events
+ */
+static int GetNextEventXY(int x, int y, int after) {
+	for (int i = GetEventTileHead(GetEventTile(x, y)); i >= 0; i = event_tile_next[i]) {
+		if (i > after && events[i].IsInPosition(x, y)) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+void Game_Map::UpdateEventPosition(const Game_Event& ev) {
+	// Events report their position while being constructed, before they are indexed.
+	if (event_tile.empty()
+			|| std::less<const Game_Event*>()(&ev, events.data())
+			|| !std::less<const Game_Event*>()(&ev, events.data() + event_tile.size())) {
+		return;
+	}
+
+	const int index = static_cast<int>(&ev - events.data());
+	if (event_tile[index] == GetEventTile(ev.GetX(), ev.GetY())) {
+		return;
+	}
+
+	UnlinkEvent(index);
+	LinkEvent(index);
+}
+
+/**
+ * Refreshes the events whose page conditions depend on switches or
+ * variables changed since the last refresh. The other events would select
+ * the same page again.
+ */
+static void RefreshEvents() {
+	static std::vector<int> changed_ids;
+	static std::vector<bool> needs_refresh;
+
+	bool all = refresh_all_events;
+	refresh_all_events = false;
+
+	needs_refresh.assign(events.size(), false);
+	auto mark = [](const std::unordered_map<int, std::vector<int>>& index, const std::vector<int>& ids) {
+		for (int id : ids) {
+			auto it = index.find(id);
+			if (it == index.end()) {
+				continue;
+			}
+			for (int event_index : it->second) {
+				needs_refresh[event_index] = true;
+			}
+		}
+	};
+
+	changed_ids.clear();
+	all |= !Game_Switches.TakeChanges(changed_ids);
+	mark(switch_refresh_index, changed_ids);
+
+	changed_ids.clear();
+	all |= !Game_Variables.TakeChanges(changed_ids);
+	mark(variable_refresh_index, changed_ids);
+
+	for (int event_index : always_refresh_events) {
+		needs_refresh[event_index] = true;
+	}
+
+	// Same order as a full refresh
+	for (size_t i = 0; i < events.size(); ++i) {
+		if (all || needs_refresh[i]) {
+			events[i].Refresh();
+		}
+	}
+}
+
 void Game_Map::Refresh() {
 	if (location.map_id > 0) {
-		for (Game_Event& ev : events) {
-			ev.Refresh();
-		}
+		RefreshEvents();
 
 		if (refresh_type == Refresh_All) {
 			for (Game_CommonEvent& ev : common_events) {
@@ -523,7 +727,7 @@ static bool WouldCollide(const Game_Character& self, const Game_Character& other
 }
 
 template <typename T>
-static bool MakeWayCollideEvent(int x, int y, const Game_Character& self, T& other, bool self_conflict) {
+static bool MakeWayCollideEvent(int x, int y, const Game_Character& self, T& other, bool self_conflict, bool update_other) {
 	if (&self == &other) {
 		return false;
 	}
@@ -532,28 +736,39 @@ static bool MakeWayCollideEvent(int x, int y, const Game_Character& self, T& oth
 		return false;
 	}
 
-	// Force the other event to update, allowing them to possibly move out of the way.
-	other.Update();
+	if (update_other) {
+		// Force the other event to update, allowing them to possibly move out of the way.
+		other.Update();
 
-	if (!other.IsInPosition(x, y)) {
-		return false;
+		if (!other.IsInPosition(x, y)) {
+			return false;
+		}
 	}
 
 	return WouldCollide(self, other, self_conflict);
 }
 
-bool Game_Map::MakeWay(const Game_Character& self, int x, int y) {
+enum class WayMode {
+	/** Collide with other characters, update them to move out of the way */
+	MakeWay,
+	/** Collide with other characters without updating them */
+	Check,
+	/** Only check the map passability */
+	IgnoreCharacters
+};
+
+static bool CheckWay(const Game_Character& self, int from_x, int from_y, int x, int y, WayMode mode) {
 	// Moving to same tile (used for jumps) always succeeds
-	if (x == self.GetX() && y == self.GetY()) {
+	if (x == from_x && y == from_y) {
 		return true;
 	}
-	if (!self.IsJumping() && x != self.GetX() && y != self.GetY()) {
+	if (!self.IsJumping() && x != from_x && y != from_y) {
 		// Handle diagonal stepping.
 		// Must be able to step on at least one of the 2 adjacent tiles and also the target tile.
 		// Verified behavior: Always checks vertical first, only checks horizontal if vertical fails.
-		bool vertical_ok = MakeWay(self, self.GetX(), y);
+		bool vertical_ok = CheckWay(self, from_x, from_y, from_x, y, mode);
 		if (!vertical_ok) {
-			bool horizontal_ok = MakeWay(self, x, self.GetY());
+			bool horizontal_ok = CheckWay(self, from_x, from_y, x, from_y, mode);
 			if (!horizontal_ok) {
 				return false;
 			}
@@ -561,8 +776,8 @@ bool Game_Map::MakeWay(const Game_Character& self, int x, int y) {
 	}
 
 	// Infer directions before we do any rounding.
-	const auto bit_from = GetPassableMask(self.GetX(), self.GetY(), x, y);
-	const auto bit_to = GetPassableMask(x, y, self.GetX(), self.GetY());
+	const auto bit_from = GetPassableMask(from_x, from_y, x, y);
+	const auto bit_to = GetPassableMask(x, y, from_x, from_y);
 
 	// Now round for looping maps.
 	x = Game_Map::RoundX(x);
@@ -594,36 +809,38 @@ bool Game_Map::MakeWay(const Game_Character& self, int x, int y) {
 		if (vehicle_type == Game_Vehicle::None) {
 			// Check that we are allowed to step off of the current tile.
 			// Note: Vehicles can always step off a tile.
-			if (!IsPassableTile(&self, bit_from, self.GetX(), self.GetY())) {
+			if (!Game_Map::IsPassableTile(&self, bit_from, from_x, from_y)) {
 				return false;
 			}
 		}
 	}
 
-	if (vehicle_type != Game_Vehicle::Airship) {
+	if (vehicle_type != Game_Vehicle::Airship && mode != WayMode::IgnoreCharacters) {
+		const bool update = (mode == WayMode::MakeWay);
+
 		// Check for collision with events on the target tile.
-		for (auto& other: GetEvents()) {
-			if (MakeWayCollideEvent(x, y, self, other, self_conflict)) {
+		for (int i = GetNextEventXY(x, y, -1); i >= 0; i = GetNextEventXY(x, y, i)) {
+			if (MakeWayCollideEvent(x, y, self, events[i], self_conflict, update)) {
 				return false;
 			}
 		}
 		auto& player = Main_Data::game_player;
 		if (player->GetVehicleType() == Game_Vehicle::None) {
-			if (MakeWayCollideEvent(x, y, self, *Main_Data::game_player, self_conflict)) {
+			if (MakeWayCollideEvent(x, y, self, *Main_Data::game_player, self_conflict, update)) {
 				return false;
 			}
 		}
 		for (auto vid: { Game_Vehicle::Boat, Game_Vehicle::Ship}) {
 			auto& other = vehicles[vid - 1];
 			if (other->IsInCurrentMap()) {
-				if (MakeWayCollideEvent(x, y, self, *other, self_conflict)) {
+				if (MakeWayCollideEvent(x, y, self, *other, self_conflict, update)) {
 					return false;
 				}
 			}
 		}
 		auto& airship = vehicles[Game_Vehicle::Airship - 1];
 		if (airship->IsInCurrentMap() && self.GetType() != Game_Character::Player) {
-			if (MakeWayCollideEvent(x, y, self, *airship, self_conflict)) {
+			if (MakeWayCollideEvent(x, y, self, *airship, self_conflict, update)) {
 				return false;
 			}
 		}
@@ -634,7 +851,15 @@ bool Game_Map::MakeWay(const Game_Character& self, int x, int y) {
 		bit = Passable::Down | Passable::Up | Passable::Left | Passable::Right;
 	}
 
-	return IsPassableTile(&self, bit, x, y);
+	return Game_Map::IsPassableTile(&self, bit, x, y);
+}
+
+bool Game_Map::MakeWay(const Game_Character& self, int x, int y) {
+	return CheckWay(self, self.GetX(), self.GetY(), x, y, WayMode::MakeWay);
+}
+
+bool Game_Map::CanStep(const Game_Character& self, int from_x, int from_y, int x, int y, bool check_characters) {
+	return CheckWay(self, from_x, from_y, x, y, check_characters ? WayMode::Check : WayMode::IgnoreCharacters);
 }
 
 bool Game_Map::CanLandAirship(int x, int y) {
@@ -649,10 +874,9 @@ bool Game_Map::CanLandAirship(int x, int y) {
 		return false;
 	}
 
-	for (auto& ev: events) {
-		if (ev.IsInPosition(x, y)
-				&& ev.IsActive()
-				&& ev.GetActivePage() != nullptr) {
+	for (int i = GetNextEventXY(x, y, -1); i >= 0; i = GetNextEventXY(x, y, i)) {
+		const Game_Event& ev = events[i];
+		if (ev.IsActive() && ev.GetActivePage() != nullptr) {
 			return false;
 		}
 	}
@@ -665,16 +889,13 @@ bool Game_Map::CanLandAirship(int x, int y) {
 
 	const int bit = Passable::Down | Passable::Right | Passable::Left | Passable::Up;
 
-	int tile_index = x + y * GetWidth();
+	const int passages = tile_passages[x + y * GetWidth()];
 
-	if (!IsPassableLowerTile(bit, tile_index)) {
+	if (((passages >> 8) & bit) == 0) {
 		return false;
 	}
 
-	int tile_id = map->upper_layer[tile_index] - BLOCK_F;
-	tile_id = map_info.upper_tiles[tile_id];
-
-	return (passages_up[tile_id] & bit) != 0;
+	return (passages & bit) != 0;
 }
 
 bool Game_Map::CanEmbarkShip(Game_Player& player, int x, int y) {
@@ -687,9 +908,9 @@ bool Game_Map::CanDisembarkShip(Game_Player& player, int x, int y) {
 		return false;
 	}
 
-	for (auto& ev: GetEvents()) {
-		if (ev.IsInPosition(x, y)
-			&& ev.GetLayer() == RPG::EventPage::Layers_same
+	for (int i = GetNextEventXY(x, y, -1); i >= 0; i = GetNextEventXY(x, y, i)) {
+		const Game_Event& ev = events[i];
+		if (ev.GetLayer() == RPG::EventPage::Layers_same
 			&& ev.IsActive()
 			&& ev.GetActivePage() != nullptr) {
 			return false;
@@ -755,14 +976,15 @@ bool Game_Map::IsPassableTile(const Game_Character* self, int bit, int x, int y)
 
 	// Highest ID event with layer=below, not through, and a tile graphic wins.
 	int event_tile_id = 0;
-	for (auto& ev: events) {
+	for (int i = GetNextEventXY(x, y, -1); i >= 0; i = GetNextEventXY(x, y, i)) {
+		const Game_Event& ev = events[i];
 		if (self == &ev) {
 			continue;
 		}
 		if (!ev.IsActive() || ev.GetActivePage() == nullptr || ev.GetThrough()) {
 			continue;
 		}
-		if (ev.IsInPosition(x, y) && ev.GetLayer() == RPG::EventPage::Layers_below) {
+		if (ev.GetLayer() == RPG::EventPage::Layers_below) {
 			int tile_id = ev.GetTileId();
 			if (tile_id > 0) {
 				event_tile_id = tile_id;
@@ -785,23 +1007,21 @@ bool Game_Map::IsPassableTile(const Game_Character* self, int bit, int x, int y)
 		};
 	}
 
-	int tile_index = x + y * GetWidth();
-	int tile_id = map->upper_layer[tile_index] - BLOCK_F;
-	tile_id = map_info.upper_tiles[tile_id];
+	const int passages = tile_passages[x + y * GetWidth()];
 
 	if (vehicle_type == Game_Vehicle::Boat || vehicle_type == Game_Vehicle::Ship) {
-		if ((passages_up[tile_id] & Passable::Above) == 0)
+		if ((passages & Passable::Above) == 0)
 			return false;
 		return true;
 	}
 
-	if ((passages_up[tile_id] & bit) == 0)
+	if ((passages & bit) == 0)
 		return false;
 
-	if ((passages_up[tile_id] & Passable::Above) == 0)
+	if ((passages & Passable::Above) == 0)
 		return true;
 
-	return IsPassableLowerTile(bit, tile_index);
+	return ((passages >> 8) & bit) != 0;
 }
 
 int Game_Map::GetBushDepth(int x, int y) {
@@ -818,10 +1038,7 @@ int Game_Map::GetBushDepth(int x, int y) {
 bool Game_Map::IsCounter(int x, int y) {
 	if (!Game_Map::IsValid(x, y)) return false;
 
-	int const tile_id = map->upper_layer[x + y * GetWidth()];
-	if (tile_id < BLOCK_F) return false;
-	int const index = map_info.upper_tiles[tile_id - BLOCK_F];
-	return !!(passages_up[index] & Passable::Counter);
+	return !!(tile_passages[x + y * GetWidth()] & Passable::Counter);
 }
 
 int Game_Map::GetTerrainTag(int x, int y) {
@@ -845,29 +1062,86 @@ int Game_Map::GetTerrainTag(int x, int y) {
 		y = RoundY(y);
 	}
 
+	if (Game_Map::IsValid(x, y)) {
+		return tile_terrain[x + y * GetWidth()];
+	}
+
 	// RPG_RT always uses the terrain of the first lower tile
 	// for out of bounds coordinates.
-	unsigned chip_index = 0;
+	return terrain_data[0];
+}
 
-	if (Game_Map::IsValid(x, y)) {
-		const auto chip_id = map->lower_layer[x + y * GetWidth()];
-		chip_index = ChipIdToIndex(chip_id);
+/**
+ * Computes the grid entries of a tile from the map layers, the
+ * tile substitutions and the chipset.
+ *
+ * @param tile_index index of the tile
+ */
+static void UpdateTile(int tile_index) {
+	const int upper_chip_id = map->upper_layer[tile_index];
+	int passages = 0;
+	if (upper_chip_id >= BLOCK_F) {
+		passages = passages_up[map_info.upper_tiles[upper_chip_id - BLOCK_F]];
+	} else {
+		// Does not happen in valid maps: Behave like the first upper tile without counter
+		passages = passages_up[0] & ~Passable::Counter;
+	}
+	passages &= Passable::Down | Passable::Left | Passable::Right | Passable::Up
+		| Passable::Above | Passable::Counter;
+
+	for (int bit: { Passable::Down, Passable::Left, Passable::Right, Passable::Up }) {
+		if (Game_Map::IsPassableLowerTile(bit, tile_index)) {
+			passages |= bit << 8;
+		}
+	}
+	tile_passages[tile_index] = static_cast<uint16_t>(passages);
+
+	int terrain_id = 1;
+	if (chipset && !chipset->terrain_data.empty()) {
+		unsigned chip_index = ChipIdToIndex(map->lower_layer[tile_index]);
 
 		// Apply tile substitution
 		if (chip_index >= BLOCK_E_INDEX && chip_index < NUM_LOWER_TILES) {
 			chip_index = map_info.lower_tiles[chip_index - BLOCK_E_INDEX] + BLOCK_E_INDEX;
 		}
+
+		assert(chip_index < chipset->terrain_data.size());
+		terrain_id = chipset->terrain_data[chip_index];
 	}
+	tile_terrain[tile_index] = static_cast<int16_t>(terrain_id);
+}
 
-	assert(chip_index < terrain_data.size());
+static void BuildTileGrid() {
+	const int num_tiles = Game_Map::GetWidth() * Game_Map::GetHeight();
+	tile_passages.assign(num_tiles, 0);
+	tile_terrain.assign(num_tiles, 1);
+
+	for (int i = 0; i < num_tiles; ++i) {
+		UpdateTile(i);
+	}
+}
 
-	return terrain_data[chip_index];
+/**
+ * Recomputes the grid entries of all tiles using one of the substituted tiles.
+ *
+ * @param layer lower or upper map layer
+ * @param block first chip ID of the substitutable block of the layer
+ * @param changed substitution table entries that changed
+ */
+static void UpdateSubstitutedTiles(const std::vector<int16_t>& layer, int block, const std::vector<bool>& changed) {
+	for (size_t i = 0; i < layer.size() && i < tile_passages.size(); ++i) {
+		const int index = layer[i] - block;
+		if (index >= 0 && index < static_cast<int>(changed.size()) && changed[index]) {
+			UpdateTile(i);
+		}
+	}
 }
 
 void Game_Map::GetEventsXY(std::vector<Game_Event*>& events, int x, int y) {
-	for (Game_Event& ev : GetEvents()) {
-		if (ev.IsInPosition(x, y) && ev.IsActive()) {
-			events.push_back(&ev);
+	auto& map_events = GetEvents();
+	for (int i = GetNextEventXY(x, y, -1); i >= 0; i = GetNextEventXY(x, y, i)) {
+		if (map_events[i].IsActive()) {
+			events.push_back(&map_events[i]);
 		}
 	}
 }
@@ -905,13 +1179,8 @@ int Game_Map::YwithDirection(int y, int direction) {
 }
 
 int Game_Map::CheckEvent(int x, int y) {
-	for (const Game_Event& ev : events) {
-		if (ev.IsInPosition(x, y)) {
-			return ev.GetId();
-		}
-	}
-
-	return 0;
+	int i = GetNextEventXY(x, y, -1);
+	return i >= 0 ? events[i].GetId() : 0;
 }
 
 static bool RunNextForegroundCommonEvent(Game_Interpreter_Map& interp) {
@@ -957,7 +1226,10 @@ static bool RunNextForegroundMapEvent(Game_Interpreter_Map& interp) {
 }
 
 void Game_Map::Update(bool is_preupdate) {
+	EP_PROFILE_ZONE(Zone_MapUpdate);
+
 	if (GetNeedRefresh() != Refresh_None) Refresh();
+	Game_Pathfinder::Update();
 	if (animation) {
 		animation->Update();
 		if (animation->IsDone()) {
@@ -1420,6 +1692,10 @@ void Game_Map::SetChipset(int id) {
 		passages_down.resize(162, (unsigned char) 0x0F);
 	if (passages_up.size() < 144)
 		passages_up.resize(144, (unsigned char) 0x0F);
+
+	if (map) {
+		BuildTileGrid();
+	}
 }
 
 Game_Vehicle* Game_Map::GetVehicle(Game_Vehicle::Type which) {
@@ -1434,7 +1710,7 @@ Game_Vehicle* Game_Map::GetVehicle(Game_Vehicle::Type which) {
 
 bool Game_Map::IsAnyEventStarting() {
 	for (Game_Event& ev : events)
-		if (ev.IsWaitingForegroundExecution() && !ev.GetList().empty() && ev.IsActive())
+		if (ev.IsWaitingForegroundExecution() && !ev.GetList()->empty() && ev.IsActive())
 			return true;
 
 	for (Game_CommonEvent& ev : common_events)
@@ -1472,11 +1748,13 @@ void Game_Map::RemoveAllPendingMoves() {
 	}
 }
 
-static int DoSubstitute(std::vector<uint8_t>& tiles, int old_id, int new_id) {
+static int DoSubstitute(std::vector<uint8_t>& tiles, int old_id, int new_id, std::vector<bool>& changed) {
 	int num_subst = 0;
+	changed.assign(tiles.size(), false);
 	for (size_t i = 0; i < tiles.size(); ++i) {
 		if (tiles[i] == old_id) {
 			tiles[i] = (uint8_t) new_id;
+			changed[i] = true;
 			++num_subst;
 		}
 	}
@@ -1484,11 +1762,21 @@ static int DoSubstitute(std::vector<uint8_t>& tiles, int old_id, int new_id) {
 }
 
 int Game_Map::SubstituteDown(int old_id, int new_id) {
-	return DoSubstitute(map_info.lower_tiles, old_id, new_id);
+	std::vector<bool> changed;
+	int num_subst = DoSubstitute(map_info.lower_tiles, old_id, new_id, changed);
+	if (num_subst > 0) {
+		UpdateSubstitutedTiles(map->lower_layer, BLOCK_E, changed);
+	}
+	return num_subst;
 }
 
 int Game_Map::SubstituteUp(int old_id, int new_id) {
-	return DoSubstitute(map_info.upper_tiles, old_id, new_id);
+	std::vector<bool> changed;
+	int num_subst = DoSubstitute(map_info.upper_tiles, old_id, new_id, changed);
+	if (num_subst > 0) {
+		UpdateSubstitutedTiles(map->upper_layer, BLOCK_F, changed);
+	}
+	return num_subst;
 }
 
 void Game_Map::LockPan() {
@@ -152,6 +152,21 @@ namespace Game_Map {
 	 */
 	bool MakeWay(const Game_Character& self, int x, int y);
 
+	/**
+	 * Checks if self could move from (from_x,from_y) to (x,y) without
+	 * side effects: Unlike MakeWay the blocking events are not updated.
+	 * Used by the pathfinder to test steps away from the current position.
+	 *
+	 * @param self Character to move.
+	 * @param from_x tile x the move starts on.
+	 * @param from_y tile y the move starts on.
+	 * @param x new tile x.
+	 * @param y new tile y.
+	 * @param check_characters whether other characters block the move.
+	 * @return whether is passable.
+	 */
+	bool CanStep(const Game_Character& self, int from_x, int from_y, int x, int y, bool check_characters);
+
 	/**
 	 * Gets if possible to land the airship at (x,y)
 	 *
@@ -500,8 +515,24 @@ namespace Game_Map {
 	 */
 	std::vector<Game_CommonEvent>& GetCommonEvents();
 
+	/**
+	 * Gets the active events at a position, ordered by event index.
+	 *
+	 * @param events receives the events
+	 * @param x tile x
+	 * @param y tile y
+	 */
 	void GetEventsXY(std::vector<Game_Event*>& events, int x, int y);
 
+	/**
+	 * Moves an event to its new tile in the spatial event index.
+	 * Called by Game_Character whenever the position of an event changes.
+	 * Events not (yet) part of the map event list are ignored.
+	 *
+	 * @param ev event that moved
+	 */
+	void UpdateEventPosition(const Game_Event& ev);
+
 	bool LoopHorizontal();
 	bool LoopVertical();
 
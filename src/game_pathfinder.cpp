@@ -0,0 +1,308 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <queue>
+#include <unordered_map>
+#include "game_pathfinder.h"
+#include "game_character.h"
+#include "game_map.h"
+#include "utils.h"
+
+namespace {
+	// Step offsets in the order of Game_Character::Direction (Up, Right, Down, Left)
+	constexpr int step_x[] = { 0, 1, 0, -1 };
+	constexpr int step_y[] = { -1, 0, 1, 0 };
+
+	struct Node {
+		int f;
+		int g;
+		int tile;
+
+		bool operator<(const Node& other) const {
+			// Lowest cost first, prefer the node closer to the goal on equal cost
+			return f != other.f ? f > other.f : g < other.g;
+		}
+	};
+
+	// Search state, kept between searches to avoid allocations.
+	// A tile was visited by the current search when its stamp matches.
+	std::vector<uint32_t> visit_stamp;
+	std::vector<int> visit_cost;
+	std::vector<int8_t> visit_dir;
+	uint32_t current_stamp = 0;
+
+	struct CachedPath {
+		int map_id = 0;
+		int target_x = 0;
+		int target_y = 0;
+		// Tile the next step starts on
+		int x = 0;
+		int y = 0;
+		std::vector<int> steps;
+		size_t next = 0;
+		bool reached = false;
+		int frame = 0;
+	};
+
+	std::unordered_map<const Game_Character*, CachedPath> cache;
+
+	int frame = 0;
+	int frame_nodes = 0;
+}
+
+static int Distance(int from, int to, int size, bool loop) {
+	int d = std::abs(to - from);
+	if (loop) {
+		d = std::min(d, size - d);
+	}
+	return d;
+}
+
+Game_Pathfinder::Result Game_Pathfinder::Search(const Grid& grid, int start_x, int start_y, int goal_x, int goal_y, int max_nodes) {
+	Result result;
+
+	const int num_tiles = grid.width * grid.height;
+	if (start_x < 0 || start_x >= grid.width || start_y < 0 || start_y >= grid.height) {
+		return result;
+	}
+
+	if (static_cast<int>(visit_stamp.size()) != num_tiles || ++current_stamp == 0) {
+		visit_stamp.assign(num_tiles, 0);
+		visit_cost.resize(num_tiles);
+		visit_dir.resize(num_tiles);
+		current_stamp = 1;
+	}
+
+	auto heuristic = [&](int x, int y) {
+		return Distance(x, goal_x, grid.width, grid.loop_horizontal)
+			+ Distance(y, goal_y, grid.height, grid.loop_vertical);
+	};
+
+	const int start_tile = start_x + start_y * grid.width;
+	const int goal_tile = (goal_x >= 0 && goal_x < grid.width && goal_y >= 0 && goal_y < grid.height)
+		? goal_x + goal_y * grid.width : -1;
+
+	std::priority_queue<Node> open;
+	visit_stamp[start_tile] = current_stamp;
+	visit_cost[start_tile] = 0;
+	visit_dir[start_tile] = -1;
+	open.push({ heuristic(start_x, start_y), 0, start_tile });
+
+	int best_tile = start_tile;
+	int best_h = heuristic(start_x, start_y);
+
+	while (!open.empty()) {
+		const Node node = open.top();
+		open.pop();
+
+		if (node.g > visit_cost[node.tile]) {
+			// Superseded by a cheaper way to the same tile
+			continue;
+		}
+
+		if (node.tile == goal_tile) {
+			result.reached = true;
+			best_tile = goal_tile;
+			break;
+		}
+
+		if (result.nodes >= max_nodes) {
+			break;
+		}
+		++result.nodes;
+
+		const int x = node.tile % grid.width;
+		const int y = node.tile / grid.width;
+
+		const int h = node.f - node.g;
+		if (h < best_h || (h == best_h && node.g < visit_cost[best_tile])) {
+			best_tile = node.tile;
+			best_h = h;
+		}
+
+		for (int dir = 0; dir < 4; ++dir) {
+			int nx = x + step_x[dir];
+			int ny = y + step_y[dir];
+
+			if (grid.loop_horizontal) {
+				nx = Utils::PositiveModulo(nx, grid.width);
+			} else if (nx < 0 || nx >= grid.width) {
+				continue;
+			}
+			if (grid.loop_vertical) {
+				ny = Utils::PositiveModulo(ny, grid.height);
+			} else if (ny < 0 || ny >= grid.height) {
+				continue;
+			}
+
+			const int next_tile = nx + ny * grid.width;
+			const int g = node.g + 1;
+			if (visit_stamp[next_tile] == current_stamp && visit_cost[next_tile] <= g) {
+				continue;
+			}
+
+			if (!grid.can_step(x, y, dir, next_tile == goal_tile)) {
+				continue;
+			}
+
+			visit_stamp[next_tile] = current_stamp;
+			visit_cost[next_tile] = g;
+			visit_dir[next_tile] = static_cast<int8_t>(dir);
+			open.push({ g + heuristic(nx, ny), g, next_tile });
+		}
+	}
+
+	// Walk back from the reached tile to the start
+	for (int tile = best_tile; tile != start_tile; ) {
+		const int dir = visit_dir[tile];
+		result.path.push_back(dir);
+
+		int x = tile % grid.width - step_x[dir];
+		int y = tile / grid.width - step_y[dir];
+		x = Utils::PositiveModulo(x, grid.width);
+		y = Utils::PositiveModulo(y, grid.height);
+		tile = x + y * grid.width;
+	}
+	std::reverse(result.path.begin(), result.path.end());
+
+	return result;
+}
+
+static bool CanStep(const Game_Character& ch, int x, int y, int dir, bool goal) {
+	// Characters standing on the goal do not block, reaching them is the purpose
+	return Game_Map::CanStep(ch, x, y, x + step_x[dir], y + step_y[dir], !goal);
+}
+
+/**
+ * Extends a path which reached its target when the target moved to
+ * an adjacent tile. Paths which became much longer than the direct
+ * distance are searched again instead.
+ */
+static bool ExtendPath(const Game_Character& ch, CachedPath& path, int target_x, int target_y) {
+	if (!path.reached) {
+		return false;
+	}
+
+	const int remaining = static_cast<int>(path.steps.size() - path.next) + 1;
+	const int distance = Distance(path.x, target_x, Game_Map::GetWidth(), Game_Map::LoopHorizontal())
+		+ Distance(path.y, target_y, Game_Map::GetHeight(), Game_Map::LoopVertical());
+	if (remaining > distance + 4) {
+		return false;
+	}
+
+	for (int dir = 0; dir < 4; ++dir) {
+		const int x = Game_Map::RoundX(path.target_x + step_x[dir]);
+		const int y = Game_Map::RoundY(path.target_y + step_y[dir]);
+		if (x != target_x || y != target_y) {
+			continue;
+		}
+
+		if (!CanStep(ch, path.target_x, path.target_y, dir, true)) {
+			return false;
+		}
+
+		path.steps.push_back(dir);
+		path.target_x = target_x;
+		path.target_y = target_y;
+		return true;
+	}
+
+	return false;
+}
+
+int Game_Pathfinder::FindDirection(const Game_Character& ch, int target_x, int target_y) {
+	const int x = ch.GetX();
+	const int y = ch.GetY();
+
+	auto it = cache.find(&ch);
+	if (it != cache.end()) {
+		CachedPath& path = it->second;
+		const bool valid = path.map_id == Game_Map::GetMapId() && path.x == x && path.y == y;
+
+		if (valid && (path.target_x != target_x || path.target_y != target_y)) {
+			ExtendPath(ch, path, target_x, target_y);
+		}
+
+		if (valid && path.target_x == target_x && path.target_y == target_y) {
+			if (path.next < path.steps.size()) {
+				const int dir = path.steps[path.next++];
+				path.x = Game_Map::RoundX(x + step_x[dir]);
+				path.y = Game_Map::RoundY(y + step_y[dir]);
+				return dir;
+			}
+
+			if (path.steps.empty() && frame - path.frame < retry_frames) {
+				// No way was found recently, do not search again yet
+				return -1;
+			}
+		}
+	}
+
+	if (frame_nodes + max_search_nodes > frame_node_budget) {
+		// Budget spent, the search happens in a later frame
+		return -1;
+	}
+
+	Grid grid;
+	grid.width = Game_Map::GetWidth();
+	grid.height = Game_Map::GetHeight();
+	grid.loop_horizontal = Game_Map::LoopHorizontal();
+	grid.loop_vertical = Game_Map::LoopVertical();
+	grid.can_step = [&ch](int x, int y, int dir, bool goal) {
+		return CanStep(ch, x, y, dir, goal);
+	};
+
+	Result result = Search(grid, x, y, target_x, target_y);
+	frame_nodes += result.nodes;
+
+	CachedPath& path = cache[&ch];
+	path.map_id = Game_Map::GetMapId();
+	path.target_x = target_x;
+	path.target_y = target_y;
+	path.x = x;
+	path.y = y;
+	path.steps = std::move(result.path);
+	path.next = 0;
+	path.reached = result.reached;
+	path.frame = frame;
+
+	if (path.steps.empty()) {
+		return -1;
+	}
+
+	const int dir = path.steps[path.next++];
+	path.x = Game_Map::RoundX(x + step_x[dir]);
+	path.y = Game_Map::RoundY(y + step_y[dir]);
+	return dir;
+}
+
+void Game_Pathfinder::Invalidate(const Game_Character& ch) {
+	cache.erase(&ch);
+}
+
+void Game_Pathfinder::Update() {
+	++frame;
+	frame_nodes = 0;
+}
+
+void Game_Pathfinder::Reset() {
+	cache.clear();
+}
@@ -0,0 +1,108 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_GAME_PATHFINDER_H
+#define EP_GAME_PATHFINDER_H
+
+#include <functional>
+#include <vector>
+
+class Game_Character;
+
+/**
+ * A* pathfinding over the map passability.
+ * Used by events walking to a target instead of their move type.
+ */
+namespace Game_Pathfinder {
+	/** Maximum number of nodes a single search expands */
+	constexpr int max_search_nodes = 2048;
+
+	/** Maximum number of nodes expanded by all searches in one frame */
+	constexpr int frame_node_budget = 4 * max_search_nodes;
+
+	/** Frames until a search which found no way is repeated */
+	constexpr int retry_frames = 60;
+
+	/** Map to search on */
+	struct Grid {
+		int width = 0;
+		int height = 0;
+		bool loop_horizontal = false;
+		bool loop_vertical = false;
+		/**
+		 * Whether a step from (x, y) into a direction is possible.
+		 * goal is true when the step ends on the goal tile.
+		 */
+		std::function<bool(int x, int y, int dir, bool goal)> can_step;
+	};
+
+	/** Result of a search */
+	struct Result {
+		/**
+		 * Directions to walk. Leads to the goal when reached is set,
+		 * otherwise to the visited tile closest to the goal.
+		 */
+		std::vector<int> path;
+		/** Whether the goal was reached */
+		bool reached = false;
+		/** Number of expanded nodes */
+		int nodes = 0;
+	};
+
+	/**
+	 * Searches the shortest way between two tiles with steps in the
+	 * four directions of Game_Character::Direction.
+	 *
+	 * @param grid map to search on
+	 * @param start_x start tile x
+	 * @param start_y start tile y
+	 * @param goal_x goal tile x
+	 * @param goal_y goal tile y
+	 * @param max_nodes maximum number of nodes to expand
+	 * @return search result
+	 */
+	Result Search(const Grid& grid, int start_x, int start_y, int goal_x, int goal_y, int max_nodes = max_search_nodes);
+
+	/**
+	 * Gets the direction a character must walk to approach a target tile
+	 * on the current map. Paths are cached per character and continued
+	 * while the character follows them, a target moving by one tile
+	 * extends the cached path.
+	 *
+	 * @param ch character to move
+	 * @param target_x target tile x
+	 * @param target_y target tile y
+	 * @return direction or -1 when there is no way or the frame budget is spent
+	 */
+	int FindDirection(const Game_Character& ch, int target_x, int target_y);
+
+	/**
+	 * Drops the cached path of a character.
+	 * Must be called when a step along the path failed.
+	 *
+	 * @param ch character
+	 */
+	void Invalidate(const Game_Character& ch);
+
+	/** Starts a new frame and restores the node budget. */
+	void Update();
+
+	/** Drops all cached paths. */
+	void Reset();
+}
+
+#endif
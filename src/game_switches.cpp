@@ -53,7 +53,10 @@ void Game_Switches_Class::Set(int switch_id, bool value) {
 	if (switch_id > sv.size()) {
 		sv.resize(switch_id);
 	}
-	sv[switch_id - 1] = value;
+	if (sv[switch_id - 1] != value) {
+		sv[switch_id - 1] = value;
+		OnChange(switch_id);
+	}
 }
 
 void Game_Switches_Class::Flip(int switch_id) {
@@ -82,4 +85,30 @@ int Game_Switches_Class::GetSize() const {
 void Game_Switches_Class::Reset() {
 	switches().clear();
 	_warnings = 0;
+	all_changed = true;
+}
+
+void Game_Switches_Class::OnChange(int switch_id) {
+	if (all_changed) {
+		return;
+	}
+	if (switch_id > (int)changed.size()) {
+		changed.resize(switch_id);
+	}
+	if (!changed[switch_id - 1]) {
+		changed[switch_id - 1] = true;
+		changes.push_back(switch_id);
+	}
+}
+
+bool Game_Switches_Class::TakeChanges(std::vector<int>& ids) {
+	for (int id : changes) {
+		changed[id - 1] = false;
+	}
+	ids.insert(ids.end(), changes.begin(), changes.end());
+	changes.clear();
+
+	bool result = !all_changed;
+	all_changed = false;
+	return result;
 }
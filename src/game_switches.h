@@ -43,8 +43,24 @@ public:
 
 	void Reset();
 
+	/**
+	 * Gets the IDs of the switches changed since the last call.
+	 * Game_Map uses them to only refresh the events depending on them.
+	 *
+	 * @param ids receives the changed IDs
+	 * @return false when all switches must be considered changed
+	 */
+	bool TakeChanges(std::vector<int>& ids);
+
 private:
 	mutable int _warnings = 0;
+
+	void OnChange(int switch_id);
+
+	/** Changed IDs and a flag per ID to add each only once */
+	std::vector<int> changes;
+	std::vector<bool> changed;
+	bool all_changed = true;
 };
 
 
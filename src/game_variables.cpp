@@ -56,7 +56,11 @@ void Game_Variables_Class::Set(int variable_id, int value) {
 	}
 	const int maxval = Player::IsRPG2k3() ? 9999999 : 999999;
 	const int minval = Player::IsRPG2k3() ? -9999999 : -999999;
-	vv[variable_id - 1] = std::max(std::min(value, maxval), minval);
+	value = std::max(std::min(value, maxval), minval);
+	if (vv[variable_id - 1] != value) {
+		vv[variable_id - 1] = value;
+		OnChange(variable_id);
+	}
 }
 
 std::string Game_Variables_Class::GetName(int _id) const {
@@ -81,4 +85,30 @@ int Game_Variables_Class::GetSize() const {
 void Game_Variables_Class::Reset() {
 	variables().clear();
 	_warnings = 0;
+	all_changed = true;
+}
+
+void Game_Variables_Class::OnChange(int variable_id) {
+	if (all_changed) {
+		return;
+	}
+	if (variable_id > (int)changed.size()) {
+		changed.resize(variable_id);
+	}
+	if (!changed[variable_id - 1]) {
+		changed[variable_id - 1] = true;
+		changes.push_back(variable_id);
+	}
+}
+
+bool Game_Variables_Class::TakeChanges(std::vector<int>& ids) {
+	for (int id : changes) {
+		changed[id - 1] = false;
+	}
+	ids.insert(ids.end(), changes.begin(), changes.end());
+	changes.clear();
+
+	bool result = !all_changed;
+	all_changed = false;
+	return result;
 }
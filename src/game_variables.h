@@ -21,6 +21,7 @@
 // Headers
 #include "data.h"
 #include <string>
+#include <vector>
 
 /**
  * Game_Variables class.
@@ -40,8 +41,24 @@ public:
 	int GetSize() const;
 
 	void Reset();
+
+	/**
+	 * Gets the IDs of the variables changed since the last call.
+	 * Game_Map uses them to only refresh the events depending on them.
+	 *
+	 * @param ids receives the changed IDs
+	 * @return false when all variables must be considered changed
+	 */
+	bool TakeChanges(std::vector<int>& ids);
 private:
 	mutable int _warnings = 0;
+
+	void OnChange(int variable_id);
+
+	/** Changed IDs and a flag per ID to add each only once */
+	std::vector<int> changes;
+	std::vector<bool> changed;
+	bool all_changed = true;
 };
 
 // Global variable
@@ -17,9 +17,11 @@
 
 // Headers
 #include <sstream>
+#include <algorithm>
 #include <array>
 
 #include "graphics.h"
+#include "benchmark.h"
 #include "cache.h"
 #include "output.h"
 #include "player.h"
@@ -34,6 +36,10 @@ namespace Graphics {
 	void LocalDraw(int priority = Priority::Priority_Maximum);
 	void GlobalDraw(int priority = Priority::Priority_Maximum);
 
+	bool CollectDamage();
+	void AddDamage(Rect rect);
+	bool NeedsDraw(const Drawable* drawable);
+
 	int framerate;
 
 	uint32_t next_fps_time;
@@ -42,10 +48,40 @@ namespace Graphics {
 	std::shared_ptr<State> global_state;
 
 	bool SortDrawableList(const Drawable* first, const Drawable* second);
+	DrawableList& GetDrawableList(const Drawable* drawable);
+
+	/** Counter for sort keys placing a drawable behind its equal Z drawables */
+	int64_t drawable_sequence = 0;
+	/** Counter for sort keys placing a drawable before its equal Z drawables */
+	int64_t drawable_front_sequence = 0;
 
 	std::unique_ptr<Transition> transition;
 	std::unique_ptr<MessageOverlay> message_overlay;
 	std::unique_ptr<FpsOverlay> fps_overlay;
+
+	/** Screen areas redrawn in the current frame */
+	std::vector<Rect> damage;
+	/** Screen areas of drawables removed since the last frame */
+	std::vector<Rect> removed_damage;
+	/** When set the next frame redraws the whole screen */
+	bool full_redraw = true;
+	/** When set only drawables touching the damaged areas are drawn */
+	bool partial_draw = false;
+	/** Signature of the properties affecting the whole screen */
+	uint64_t screen_signature = 0;
+
+	/** More damaged areas than this are merged into one */
+	constexpr size_t max_damage_rects = 16;
+}
+
+namespace {
+	Rect GetBoundingRect(const Rect& a, const Rect& b) {
+		int left = std::min(a.x, b.x);
+		int top = std::min(a.y, b.y);
+		int right = std::max(a.x + a.width, b.x + b.width);
+		int bottom = std::max(a.y + a.height, b.y + b.height);
+		return Rect(left, top, right - left, bottom - top);
+	}
 }
 
 unsigned SecondToFrame(float const second) {
@@ -124,14 +160,42 @@ void Graphics::UpdateTitle() {
 void Graphics::Draw() {
 	fps_overlay->AddFrame();
 
+	BitmapRef disp = DisplayUi->GetDisplaySurface();
+
+	partial_draw = CollectDamage();
+	if (partial_draw) {
+		if (damage.empty()) {
+			// Nothing changed, the display surface is still up to date
+			partial_draw = false;
+			DisplayUi->SetDisplayDamage(damage);
+
+			Benchmark::ScopedTimer timer(Benchmark::Section_UpdateDisplay);
+			DisplayUi->UpdateDisplay();
+			return;
+		}
+
+		disp->SetClipRects(damage);
+	}
+
 	if (transition->IsErased()) {
 		DisplayUi->CleanDisplay();
+	} else {
+		Benchmark::ScopedTimer timer(Benchmark::Section_LocalDraw);
+		LocalDraw();
+	}
+
+	{
+		Benchmark::ScopedTimer timer(Benchmark::Section_GlobalDraw);
 		GlobalDraw();
-		DisplayUi->UpdateDisplay();
-		return;
 	}
-	LocalDraw();
-	GlobalDraw();
+
+	if (partial_draw) {
+		disp->SetClipRects(std::vector<Rect>());
+		DisplayUi->SetDisplayDamage(damage);
+		partial_draw = false;
+	}
+
+	Benchmark::ScopedTimer timer(Benchmark::Section_UpdateDisplay);
 	DisplayUi->UpdateDisplay();
 }
 
@@ -140,18 +204,11 @@ void Graphics::LocalDraw(int priority) {
 
 	DrawableList& drawable_list = state.drawable_list;
 
-	if (state.zlist_dirty) {
-		// stable sort to work around a flickering event sprite issue when
-		// the map is scrolling (have same Z value)
-		std::stable_sort(drawable_list.begin(), drawable_list.end(), SortDrawableList);
-		state.zlist_dirty = false;
-	}
-
 	if (!drawable_list.empty())
 		current_scene->DrawBackground();
 
 	for (Drawable* drawable : drawable_list) {
-		if (drawable->GetZ() <= priority) {
+		if (drawable->GetZ() <= priority && NeedsDraw(drawable)) {
 			drawable->Draw();
 		}
 	}
@@ -160,16 +217,100 @@ void Graphics::LocalDraw(int priority) {
 void Graphics::GlobalDraw(int priority) {
 	DrawableList& drawable_list = global_state->drawable_list;
 
-	if (global_state->zlist_dirty) {
-		std::stable_sort(drawable_list.begin(), drawable_list.end(), SortDrawableList);
-		global_state->zlist_dirty = false;
-	}
 	for (Drawable* drawable : drawable_list)
-		if (drawable->GetZ() <= priority)
+		if (drawable->GetZ() <= priority && NeedsDraw(drawable))
 			drawable->Draw();
 }
 
+bool Graphics::CollectDamage() {
+	bool full = full_redraw;
+	full_redraw = false;
+
+	State& state = current_scene->GetGraphicsState();
+
+	DrawState screen;
+	screen.Add(current_scene.get())
+		.Add(transition->IsErased())
+		.Add(DisplayUi->GetBackcolor())
+		.Add(state.drawable_list.empty());
+	if (screen.GetSignature() != screen_signature) {
+		screen_signature = screen.GetSignature();
+		full = true;
+	}
+
+	// The display is cleared completely while erased
+	full = full || transition->IsErased();
+
+	std::vector<Rect> rects;
+	rects.swap(removed_damage);
+
+	for (Drawable* drawable : state.drawable_list) {
+		full = !drawable->UpdateDamage(rects) || full;
+	}
+	for (Drawable* drawable : global_state->drawable_list) {
+		full = !drawable->UpdateDamage(rects) || full;
+	}
+
+	damage.clear();
+	if (full) {
+		return false;
+	}
+
+	for (const Rect& rect : rects) {
+		AddDamage(rect);
+	}
+	return true;
+}
+
+void Graphics::AddDamage(Rect rect) {
+	rect.Adjust(DisplayUi->GetDisplaySurface()->GetRect());
+	if (rect.IsEmpty()) {
+		return;
+	}
+
+	// Merge overlapping areas, the grown area can overlap previous ones
+	for (auto it = damage.begin(); it != damage.end();) {
+		if (!rect.IsOutOfBounds(*it)) {
+			rect = GetBoundingRect(rect, *it);
+			damage.erase(it);
+			it = damage.begin();
+		} else {
+			++it;
+		}
+	}
+	damage.push_back(rect);
+
+	if (damage.size() > max_damage_rects) {
+		Rect bounds = damage.front();
+		for (const Rect& r : damage) {
+			bounds = GetBoundingRect(bounds, r);
+		}
+		damage.assign(1, bounds);
+	}
+}
+
+bool Graphics::NeedsDraw(const Drawable* drawable) {
+	if (!partial_draw) {
+		return true;
+	}
+
+	Rect rect;
+	if (!drawable->GetLastDrawRect(rect)) {
+		return true;
+	}
+
+	for (const Rect& r : damage) {
+		if (!rect.IsOutOfBounds(r)) {
+			return true;
+		}
+	}
+	return false;
+}
+
 BitmapRef Graphics::SnapToBitmap(int priority) {
+	// Draws partial frames, the next frame must replace everything
+	full_redraw = true;
+
 	LocalDraw(priority);
 	GlobalDraw(priority);
 	return DisplayUi->CaptureScreen();
@@ -189,37 +330,84 @@ void Graphics::FrameReset() {
 }
 
 void Graphics::RegisterDrawable(Drawable* drawable) {
-	if (drawable->IsGlobal()) {
-		global_state->drawable_list.push_back(drawable);
-	} else {
-		current_scene->GetGraphicsState().drawable_list.push_back(drawable);
+	DrawableList& drawable_list = GetDrawableList(drawable);
+
+	auto range = std::equal_range(drawable_list.begin(), drawable_list.end(), drawable, SortDrawableList);
+	if (range.first != range.second && *range.first == drawable) {
+		// Registered again (by a base and a derived class), drawn twice
+		drawable_list.insert(range.second, drawable);
+		return;
 	}
-	UpdateZCallback();
+
+	drawable->list_key.z = drawable->GetZ();
+	drawable->list_key.sequence = ++drawable_sequence;
+
+	// Newest key, goes behind all drawables with the same Z
+	drawable_list.insert(std::upper_bound(drawable_list.begin(), drawable_list.end(), drawable, SortDrawableList), drawable);
 }
 
 void Graphics::RemoveDrawable(Drawable* drawable) {
-	DrawableList::iterator it;
-	if (drawable->IsGlobal()) {
-		it = std::find(global_state->drawable_list.begin(), global_state->drawable_list.end(), drawable);
-		if (it != global_state->drawable_list.end()) { global_state->drawable_list.erase(it); }
+	Rect rect;
+	if (drawable->GetLastDrawRect(rect)) {
+		removed_damage.push_back(rect);
 	} else {
-		State& state = current_scene->GetGraphicsState();
-		it = std::find(state.drawable_list.begin(), state.drawable_list.end(), drawable);
-		if (it != state.drawable_list.end()) { state.drawable_list.erase(it); }
+		full_redraw = true;
+	}
+
+	DrawableList& drawable_list = GetDrawableList(drawable);
+
+	auto it = std::lower_bound(drawable_list.begin(), drawable_list.end(), drawable, SortDrawableList);
+	if (it != drawable_list.end() && *it == drawable) {
+		drawable_list.erase(it);
 	}
 }
 
-void Graphics::UpdateZCallback() {
-	current_scene->GetGraphicsState().zlist_dirty = true;
-	global_state->zlist_dirty = true;
+void Graphics::UpdateZCallback(Drawable* drawable) {
+	DrawableList& drawable_list = GetDrawableList(drawable);
+
+	auto range = std::equal_range(drawable_list.begin(), drawable_list.end(), drawable, SortDrawableList);
+	if (range.first == range.second || *range.first != drawable) {
+		// Not registered in the current scene, the old key must stay valid
+		// for the list containing the drawable
+		return;
+	}
+
+	const int z = drawable->GetZ();
+	if (z == drawable->list_key.z) {
+		return;
+	}
+
+	auto count = std::distance(range.first, range.second);
+	drawable_list.erase(range.first, range.second);
+
+	// Same order as a stable sort by Z: A drawable moving up was before all
+	// drawables of its new Z, a drawable moving down was behind them
+	drawable->list_key.sequence = z > drawable->list_key.z ? --drawable_front_sequence : ++drawable_sequence;
+	drawable->list_key.z = z;
+
+	auto it = std::upper_bound(drawable_list.begin(), drawable_list.end(), drawable, SortDrawableList);
+	drawable_list.insert(it, count, drawable);
 }
 
 inline bool Graphics::SortDrawableList(const Drawable* first, const Drawable* second) {
-	return first->GetZ() < second->GetZ();
+	// Equal Z values are ordered by registration to work around a flickering
+	// event sprite issue when the map is scrolling
+	if (first->list_key.z != second->list_key.z) {
+		return first->list_key.z < second->list_key.z;
+	}
+	return first->list_key.sequence < second->list_key.sequence;
+}
+
+Graphics::DrawableList& Graphics::GetDrawableList(const Drawable* drawable) {
+	if (drawable->IsGlobal()) {
+		return global_state->drawable_list;
+	}
+	return current_scene->GetGraphicsState().drawable_list;
 }
 
 void Graphics::UpdateSceneCallback() {
 	current_scene = Scene::instance;
+	full_redraw = true;
 }
 
 int Graphics::GetDefaultFps() {
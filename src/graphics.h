@@ -36,8 +36,8 @@ namespace Graphics {
 
 	struct State {
 		State() {}
+		/** Sorted by Z, drawables with equal Z in the order a stable sort by Z keeps them */
 		DrawableList drawable_list;
-		bool zlist_dirty = false;
 	};
 
 	/**
@@ -82,7 +82,13 @@ namespace Graphics {
 	void RegisterDrawable(Drawable* drawable);
 	void RemoveDrawable(Drawable* drawable);
 
-	void UpdateZCallback();
+	/**
+	 * Moves the drawable to the position matching its new Z value.
+	 * Must be called after the Z value changed.
+	 *
+	 * @param drawable drawable with changed Z value
+	 */
+	void UpdateZCallback(Drawable* drawable);
 
 	void UpdateSceneCallback();
 
@@ -0,0 +1,111 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "headless_ui.h"
+#include "audio.h"
+#include "audio_headless.h"
+#include "bitmap.h"
+#include "player.h"
+
+HeadlessUi::HeadlessUi(long width, long height) {
+	current_display_mode.width = width;
+	current_display_mode.height = height;
+	current_display_mode.bpp = 32;
+
+	const DynamicFormat format(
+		32,
+		0x00FF0000,
+		0x0000FF00,
+		0x000000FF,
+		0xFF000000,
+		PF::NoAlpha);
+
+	Bitmap::SetFormat(Bitmap::ChooseFormat(format));
+	main_surface = Bitmap::Create(current_display_mode.width,
+		current_display_mode.height,
+		false,
+		current_display_mode.bpp
+	);
+
+#ifdef SUPPORT_AUDIO
+	if (!Player::no_audio_flag) {
+		audio_.reset(new HeadlessAudio());
+	} else {
+		audio_.reset(new EmptyAudio());
+	}
+#endif
+}
+
+HeadlessUi::~HeadlessUi() {
+}
+
+void HeadlessUi::BeginDisplayModeChange() {
+	// no-op
+}
+
+void HeadlessUi::EndDisplayModeChange() {
+	// no-op
+}
+
+void HeadlessUi::Resize(long /* width */, long /* height */) {
+	// no-op
+}
+
+void HeadlessUi::ToggleFullscreen() {
+	// no-op
+}
+
+void HeadlessUi::ToggleZoom() {
+	// no-op
+}
+
+void HeadlessUi::UpdateDisplay() {
+	// no-op, the frame stays in main_surface (see CaptureScreen)
+}
+
+void HeadlessUi::SetTitle(const std::string& /* title */) {
+	// no-op
+}
+
+bool HeadlessUi::ShowCursor(bool /* flag */) {
+	return false;
+}
+
+void HeadlessUi::ProcessEvents() {
+	// no-op, there are no input devices. Use --replay-input for input.
+}
+
+bool HeadlessUi::IsFullscreen() {
+	return false;
+}
+
+uint32_t HeadlessUi::GetTicks() const {
+	return ticks;
+}
+
+void HeadlessUi::Sleep(uint32_t time_milli) {
+	// The frame limiter truncates the remaining frame time to full ms.
+	// Round up, otherwise the virtual clock never reaches the next frame.
+	ticks += time_milli + 1;
+}
+
+#ifdef SUPPORT_AUDIO
+AudioInterface& HeadlessUi::GetAudio() {
+	return *audio_;
+}
+#endif
@@ -0,0 +1,82 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_HEADLESS_UI_H
+#define EP_HEADLESS_UI_H
+
+// Headers
+#include "baseui.h"
+#include "system.h"
+
+struct AudioInterface;
+
+/**
+ * HeadlessUi class.
+ * Renders into an in-memory surface, has no input devices and uses a
+ * virtual clock which only advances when Sleep is called. Used for
+ * benchmarking and for running on machines without a display.
+ */
+class HeadlessUi : public BaseUi {
+public:
+	/**
+	 * Constructor.
+	 *
+	 * @param width display client width.
+	 * @param height display client height.
+	 */
+	HeadlessUi(long width, long height);
+
+	/**
+	 * Destructor.
+	 */
+	~HeadlessUi() override;
+
+	/**
+	 * Inherited from BaseUi.
+	 */
+	/** @{ */
+	void BeginDisplayModeChange() override;
+	void EndDisplayModeChange() override;
+	void Resize(long width, long height) override;
+	void ToggleFullscreen() override;
+	void ToggleZoom() override;
+	void UpdateDisplay() override;
+	void SetTitle(const std::string &title) override;
+	bool ShowCursor(bool flag) override;
+
+	void ProcessEvents() override;
+
+	bool IsFullscreen() override;
+
+	uint32_t GetTicks() const override;
+	void Sleep(uint32_t time_milli) override;
+
+#ifdef SUPPORT_AUDIO
+	AudioInterface& GetAudio() override;
+#endif
+	/** @} */
+
+private:
+	/** Virtual time in ms */
+	uint32_t ticks = 0;
+
+#ifdef SUPPORT_AUDIO
+	std::unique_ptr<AudioInterface> audio_;
+#endif
+};
+
+#endif
@@ -22,9 +22,11 @@
 #include <memory>
 
 class Bitmap;
+class EventCommandList;
 class Font;
 
 typedef std::shared_ptr<Bitmap> BitmapRef;
+typedef std::shared_ptr<const EventCommandList> EventCommandListRef;
 typedef std::shared_ptr<Font> FontRef;
 
 #endif // EP_MEMORY_MANAGEMENT_H
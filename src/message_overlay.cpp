@@ -80,6 +80,17 @@ void MessageOverlay::Draw() {
 	dirty = false;
 }
 
+bool MessageOverlay::GetDrawState(DrawState& state) {
+	if (!IsAnyMessageVisible() && !show_all) {
+		return true;
+	}
+
+	state.rect = Rect(ox, oy, bitmap->GetWidth(), bitmap->GetHeight());
+	// The bitmap is updated after drawing when dirty
+	state.Add(bitmap).Add(dirty);
+	return true;
+}
+
 int MessageOverlay::GetZ() const {
 	return z;
 }
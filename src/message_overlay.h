@@ -46,6 +46,8 @@ public:
 
 	void Draw() override;
 
+	bool GetDrawState(DrawState& state) override;
+
 	int GetZ() const override;
 
 	DrawableType GetType() const override;
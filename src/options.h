@@ -65,6 +65,9 @@
 #define TREEMAP_NAME "RPG_RT.lmt"
 #define TREEMAP_NAME_EASYRPG "EASY_RT.emt"
 
+/** Database snapshot filename, stored in the save directory. */
+#define DATABASE_CACHE_NAME "easyrpg.dbcache"
+
 /**
  * RPG_RT.exe (official engine) filename.
  * Not used by emscripten.
@@ -96,6 +96,19 @@ void Plane::Draw() {
 	dst->TiledBlit(src_x, src_y, source->GetRect(), *source, dst_rect, 255);
 }
 
+bool Plane::GetDrawState(DrawState& state) {
+	if (!visible || !bitmap) return true;
+
+	state.rect = DisplayUi->GetDisplaySurface()->GetRect();
+	state.Add(bitmap).Add(tone_effect).Add(ox).Add(oy)
+		.Add(Main_Data::game_data.screen.shake_position)
+		.Add(Game_Map::LoopHorizontal());
+	if (!Game_Map::LoopHorizontal()) {
+		state.Add(Game_Map::GetDisplayX()).Add(Game_Map::GetWidth());
+	}
+	return true;
+}
+
 BitmapRef const& Plane::GetBitmap() const {
 	return bitmap;
 }
@@ -115,8 +128,10 @@ int Plane::GetZ() const {
 	return z;
 }
 void Plane::SetZ(int nz) {
-	if (z != nz) Graphics::UpdateZCallback();
-	z = nz;
+	if (z != nz) {
+		z = nz;
+		Graphics::UpdateZCallback(this);
+	}
 }
 int Plane::GetOx() const {
 	return ox;
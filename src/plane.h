@@ -34,6 +34,8 @@ public:
 
 	void Draw() override;
 
+	bool GetDrawState(DrawState& state) override;
+
 	BitmapRef const& GetBitmap() const;
 	void SetBitmap(BitmapRef const& bitmap);
 	bool GetVisible() const;
@@ -18,11 +18,13 @@
 // Headers
 
 #include <algorithm>
+#include <chrono>
 #include <cstring>
 #include <cstdlib>
 #include <iostream>
 #include <iomanip>
 #include <fstream>
+#include <limits>
 
 #ifdef _WIN32
 #  include "util_win.h"
@@ -42,7 +44,9 @@
 
 #include "async_handler.h"
 #include "audio.h"
+#include "benchmark.h"
 #include "cache.h"
+#include "database_cache.h"
 #include "dynrpg.h"
 #include "filefinder.h"
 #include "game_actors.h"
@@ -57,6 +61,7 @@
 #include "game_temp.h"
 #include "game_variables.h"
 #include "graphics.h"
+#include "headless_ui.h"
 #include "inireader.h"
 #include "input.h"
 #include "ldb_reader.h"
@@ -65,6 +70,7 @@
 #include "main_data.h"
 #include "output.h"
 #include "player.h"
+#include "profiler.h"
 #include "reader_lcf.h"
 #include "reader_util.h"
 #include "scene_battle.h"
@@ -83,7 +89,14 @@ namespace Player {
 	bool debug_flag;
 	bool hide_title_flag;
 	bool window_flag;
+	bool headless_flag;
+	bool max_speed_flag;
+	int draw_interval;
+	int bgm_buffer_ms;
+	bool database_cache_flag;
 	bool fps_flag;
+	bool profile_flag;
+	std::string profile_output_path;
 	bool new_game_flag;
 	int load_game_id;
 	int party_x_position;
@@ -115,9 +128,19 @@ namespace {
 	double start_time;
 	double next_frame;
 
+	// --max-speed statistics
+	std::chrono::steady_clock::time_point max_speed_start_time;
+	int max_speed_start_frames;
+	int max_speed_updates;
+
 	// Overwritten by --encoding
 	std::string forced_encoding;
 
+	// --benchmark
+	bool benchmark_flag;
+	int benchmark_frames;
+	bool seed_flag;
+
 	FileRequestBinding system_request_id;
 	FileRequestBinding save_request_id;
 	FileRequestBinding map_request_id;
@@ -160,6 +183,14 @@ void Player::Init(int argc, char *argv[]) {
 
 	ParseCommandLine(argc, argv);
 
+#ifdef ENABLE_PROFILER
+	Profiler::Init(profile_output_path);
+#else
+	if (!profile_output_path.empty()) {
+		Output::Debug("--profile-out ignored: Built without profiler support");
+	}
+#endif
+
 #ifdef EMSCRIPTEN
 	Output::IgnorePause(true);
 
@@ -180,10 +211,19 @@ void Player::Init(int argc, char *argv[]) {
 	}));
 #endif
 
+	if (headless_flag) {
+		// Nobody can confirm error messages
+		Output::IgnorePause(true);
+	}
+
 	Main_Data::Init();
 
 	DisplayUi.reset();
 
+	if (headless_flag) {
+		DisplayUi = std::make_shared<HeadlessUi>(SCREEN_TARGET_WIDTH, SCREEN_TARGET_HEIGHT);
+	}
+
 	if(! DisplayUi) {
 		DisplayUi = BaseUi::CreateUi
 			(SCREEN_TARGET_WIDTH,
@@ -204,6 +244,12 @@ void Player::Run() {
 	// Reset frames before starting
 	FrameReset();
 
+	if (max_speed_flag) {
+		max_speed_start_time = std::chrono::steady_clock::now();
+		max_speed_start_frames = frames;
+		max_speed_updates = 0;
+	}
+
 	// Main loop
 #ifdef EMSCRIPTEN
 	emscripten_set_main_loop(Player::MainLoop, 0, 0);
@@ -253,7 +299,7 @@ void Player::Update(bool update_scene) {
 #if !defined(USE_LIBRETRO)
 	// libretro: The frontend handles this, cores should not do rate
 	// limiting
-	if (cur_time < start_time) {
+	if (!max_speed_flag && cur_time < start_time) {
 		// Ensure this function is only called 60 times per second.
 		// Main purpose is for emscripten where the calls per second
 		// equal the display refresh rate.
@@ -261,9 +307,23 @@ void Player::Update(bool update_scene) {
 	}
 #endif
 
+	Benchmark::BeginFrame();
+
 	// Input Logic:
 	if (Input::IsTriggered(Input::TOGGLE_FPS)) {
+#ifdef ENABLE_PROFILER
+		// Cycle: Off -> FPS -> FPS and profiler zones -> Off
+		if (profile_flag) {
+			fps_flag = false;
+			profile_flag = false;
+		} else if (fps_flag) {
+			profile_flag = true;
+		} else {
+			fps_flag = true;
+		}
+#else
 		fps_flag = !fps_flag;
+#endif
 	}
 	if (Input::IsTriggered(Input::TAKE_SCREENSHOT)) {
 		Output::TakeScreenshot();
@@ -308,7 +368,10 @@ void Player::Update(bool update_scene) {
 	for (int i = 0; i < speed_modifier; ++i) {
 		Graphics::Update();
 		if (update_scene) {
-			Scene::instance->Update();
+			{
+				Benchmark::ScopedTimer timer(Benchmark::Section_SceneUpdate);
+				Scene::instance->Update();
+			}
 			// Async file loading or transition. Don't increment the frame
 			// counter as we now have to "suspend" and "resume"
 			if (Scene::IsAsyncPending()) {
@@ -324,6 +387,17 @@ void Player::Update(bool update_scene) {
 		}
 	}
 
+	if (max_speed_flag) {
+		// No rate limiting: Never sleep and only draw every Nth update
+		if (++max_speed_updates % draw_interval == 0) {
+			Graphics::Draw();
+		}
+		if (Benchmark::EndFrame()) {
+			exit_flag = true;
+		}
+		return;
+	}
+
 #ifdef EMSCRIPTEN
 	Graphics::Draw();
 #else
@@ -378,6 +452,14 @@ void Player::Exit() {
 	DisplayUi->UpdateDisplay();
 #endif
 
+	if (max_speed_flag) {
+		PrintMaxSpeedStatistics();
+	}
+	Benchmark::PrintResults();
+#ifdef ENABLE_PROFILER
+	Profiler::Quit();
+#endif
+
 	Player::ResetGameObjects();
 	Font::Dispose();
 	DynRpg::Reset();
@@ -408,7 +490,25 @@ void Player::ParseCommandLine(int argc, char *argv[]) {
 #else
 	window_flag = false;
 #endif
+#ifdef USE_HEADLESS
+	headless_flag = true;
+#else
+	headless_flag = false;
+#endif
+	max_speed_flag = false;
+	draw_interval = 1;
+#if defined(EMSCRIPTEN) && !defined(__EMSCRIPTEN_PTHREADS__)
+	// No threads available for decoding ahead
+	bgm_buffer_ms = 0;
+#else
+	bgm_buffer_ms = 250;
+#endif
+	database_cache_flag = false;
+	benchmark_flag = false;
+	benchmark_frames = 0;
+	seed_flag = false;
 	fps_flag = false;
+	profile_flag = false;
 	debug_flag = false;
 	hide_title_flag = false;
 	exit_flag = false;
@@ -443,6 +543,67 @@ void Player::ParseCommandLine(int argc, char *argv[]) {
 		if (*it == "window" || *it == "--window") {
 			window_flag = true;
 		}
+		else if (*it == "--headless") {
+			headless_flag = true;
+		}
+		else if (*it == "--max-speed") {
+			max_speed_flag = true;
+		}
+		else if (*it == "--bgm-buffer") {
+			++it;
+			if (it == args.end()) {
+				return;
+			}
+			bgm_buffer_ms = std::max(0, atoi((*it).c_str()));
+		}
+		else if (*it == "--cache-size") {
+			++it;
+			if (it == args.end()) {
+				return;
+			}
+			// Clamped to the largest byte count size_t can hold
+			const size_t max_mb = std::numeric_limits<size_t>::max() / (1024 * 1024);
+			const size_t mb = std::min<size_t>(std::max(1, atoi((*it).c_str())), max_mb);
+			Cache::SetSizeLimit(mb * 1024 * 1024);
+		}
+		else if (*it == "--database-cache") {
+			database_cache_flag = true;
+		}
+		else if (*it == "--draw-interval") {
+			++it;
+			if (it == args.end()) {
+				return;
+			}
+			draw_interval = std::max(1, atoi((*it).c_str()));
+		}
+		else if (*it == "--benchmark") {
+			++it;
+			if (it == args.end()) {
+				return;
+			}
+			benchmark_flag = true;
+			// case sensitive
+			replay_input_path = argv[it - args.begin() + 1];
+		}
+		else if (*it == "--frames") {
+			++it;
+			if (it == args.end()) {
+				return;
+			}
+			benchmark_frames = std::max(0, atoi((*it).c_str()));
+		}
+		else if (*it == "--show-profile") {
+			fps_flag = true;
+			profile_flag = true;
+		}
+		else if (*it == "--profile-out") {
+			++it;
+			if (it == args.end()) {
+				return;
+			}
+			// case sensitive
+			profile_output_path = argv[it - args.begin() + 1];
+		}
 		else if (*it == "--show-fps") {
 			fps_flag = true;
 		}
@@ -537,6 +698,7 @@ void Player::ParseCommandLine(int argc, char *argv[]) {
 				return;
 			}
 			Utils::SeedRandomNumberGenerator(atoi((*it).c_str()));
+			seed_flag = true;
 		}
 		else if (*it == "--start-map-id") {
 			++it;
@@ -633,6 +795,15 @@ void Player::ParseCommandLine(int argc, char *argv[]) {
 #if defined(_WIN32) && !defined(__WINRT__)
 	LocalFree(argv_w);
 #endif
+
+	if (benchmark_flag) {
+		// Same input and same random numbers for every run
+		if (!seed_flag) {
+			Utils::SeedRandomNumberGenerator(0);
+		}
+		max_speed_flag = true;
+		Benchmark::Init(benchmark_frames);
+	}
 }
 
 static void OnSystemFileReady(FileRequestResult* result) {
@@ -832,12 +1003,21 @@ void Player::LoadDatabase() {
 		std::string ldb = FileFinder::FindDefault(DATABASE_NAME);
 		std::string lmt = FileFinder::FindDefault(TREEMAP_NAME);
 
+		if (database_cache_flag && DatabaseCache::Load(ldb, lmt, encoding)) {
+			Output::Debug("Loaded database from cache");
+			return;
+		}
+
 		if (!LDB_Reader::Load(ldb, encoding)) {
 			Output::ErrorStr(LcfReader::GetError());
 		}
 		if (!LMT_Reader::Load(lmt, encoding)) {
 			Output::ErrorStr(LcfReader::GetError());
 		}
+
+		if (database_cache_flag && !DatabaseCache::Save(ldb, lmt, encoding)) {
+			Output::Debug("Could not create database cache");
+		}
 	}
 }
 
@@ -1005,6 +1185,15 @@ std::string Player::GetEncoding() {
 
 		std::string ldb = FileFinder::FindDefault(DATABASE_NAME);
 
+		if (database_cache_flag) {
+			// The snapshot remembers the encoding detected for the same files
+			encoding = DatabaseCache::GetEncoding(ldb, FileFinder::FindDefault(TREEMAP_NAME));
+			if (!encoding.empty()) {
+				Output::Debug("Using encoding of the database cache: %s", encoding.c_str());
+				return encoding;
+			}
+		}
+
 		std::vector<std::string> encodings;
 		std::ifstream is(ldb, std::ios::binary);
 		// Stream required due to a liblcf api change:
@@ -1057,6 +1246,15 @@ std::string Player::GetEncoding() {
 	return encoding;
 }
 
+void Player::PrintMaxSpeedStatistics() {
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - max_speed_start_time;
+	int ticks = frames - max_speed_start_frames;
+
+	Output::Debug("Max speed: %d logic ticks in %.3f s (%.1f ticks/s, %d frames drawn)",
+		ticks, elapsed.count(), elapsed.count() > 0 ? ticks / elapsed.count() : 0.0,
+		max_speed_updates / draw_interval);
+}
+
 int Player::GetSpeedModifier() {
 	if (Input::IsPressed(Input::FAST_FORWARD)) {
 		return Input::IsPressed(Input::PLUS) ? 10 : speed_modifier;
@@ -1082,8 +1280,20 @@ void Player::PrintUsage() {
 R"(EasyRPG Player - An open source interpreter for RPG Maker 2000/2003 games.
 Options:
       --battle-test N      Start a battle test with monster party N.
+      --benchmark PATH     Replays the input log at PATH as fast as possible
+                           and prints frame timing percentiles on exit.
+                           Uses seed 0 unless --seed is passed.
+      --bgm-buffer MS      Decode MS milliseconds of background music ahead on
+                           a separate thread (default 250). 0 decodes the
+                           music while mixing and is the default when
+                           threads are not available.
+      --cache-size N       Limit the memory used for cached images to N MB
+                           (default 10).
+      --database-cache     Keep the decoded database in the save directory to
+                           speed up the next start.
       --disable-audio      Disable audio (in case you prefer your own music).
       --disable-rtp        Disable support for the Runtime Package (RTP).
+      --draw-interval N    Only draw every Nth frame. Requires --max-speed.
       --encoding N         Instead of auto detecting the encoding or using
                            the one in RPG_RT.ini, the encoding N is used.
                            Use "auto" for automatic detection.
@@ -1095,15 +1305,28 @@ Options:
                             rpg2k3     - RPG Maker 2003 engine (v1.00 - v1.04)
                             rpg2k3v105 - RPG Maker 2003 engine (v1.05 - v1.09a)
                             rpg2k3e    - RPG Maker 2003 (English release) engine
+      --frames N           Stop a --benchmark run after N frames.
       --fullscreen         Start in fullscreen mode.
+      --headless           Run without display, input devices and audio output.
+                           The game runs on a virtual clock. Use together with
+                           --replay-input.
       --show-fps           Enable frames per second counter.
+      --show-profile       Show the average time of one pass through engine
+                           hot paths.
+                           Requires a build with profiler support.
       --enable-mouse       Use mouse click for decision and scroll wheel for lists
       --enable-touch       Use one/two finger tap for decision/cancel
       --hide-title         Hide the title background image and center the
                            command menu.
       --load-game-id N     Skip the title scene and load SaveN.lsd
                            (N is padded to two digits).
+      --max-speed          Run the game logic as fast as possible instead of
+                           60 times per second. Reports the achieved logic
+                           ticks per second on exit.
       --new-game           Skip the title scene and start a new game directly.
+      --profile-out PATH   Write the time spent in engine hot paths to PATH in
+                           Chrome trace-event format. Requires a build with
+                           profiler support.
       --project-path PATH  Instead of using the working directory the game in
                            PATH is used.
       --record-input PATH  Record all button input to a log file at PATH.
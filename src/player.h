@@ -226,6 +226,9 @@ namespace Player {
 	 */
 	int GetSpeedModifier();
 
+	/** Output logic ticks per second achieved in --max-speed mode */
+	void PrintMaxSpeedStatistics();
+
 	/** Output program version on stdout */
 	void PrintVersion();
 
@@ -247,9 +250,30 @@ namespace Player {
 	/** Window flag, if true will run in window mode instead of full screen. */
 	extern bool window_flag;
 
+	/** Headless flag, if true will run without display, input and audio devices. */
+	extern bool headless_flag;
+
+	/** Max speed flag, if true the game logic runs without frame rate limit. */
+	extern bool max_speed_flag;
+
+	/** In max speed mode only every Nth frame is drawn */
+	extern int draw_interval;
+
+	/** Milliseconds of BGM decoded ahead by the audio decode thread, 0 decodes in the mixer */
+	extern int bgm_buffer_ms;
+
+	/** Database cache flag, if true the decoded database is kept as snapshot in the save directory. */
+	extern bool database_cache_flag;
+
 	/** FPS flag, if true will display frames per second counter. */
 	extern bool fps_flag;
 
+	/** Profile flag, if true will display the time spent in profiler zones. */
+	extern bool profile_flag;
+
+	/** Path to write profiler trace events to */
+	extern std::string profile_output_path;
+
 	/** Mouse flag, if true enables mouse click and scroll wheel */
 	extern bool mouse_flag;
 
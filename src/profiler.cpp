@@ -0,0 +1,148 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "system.h"
+
+#ifdef ENABLE_PROFILER
+
+// Headers
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#include "profiler.h"
+#include "filefinder.h"
+#include "output.h"
+
+namespace {
+	using clock = std::chrono::steady_clock;
+
+	const char* const zone_names[Profiler::Zone_Count] = {
+		"Game_Map::Update",
+		"Game_Interpreter::Update",
+		"TilemapLayer::Draw",
+		"Sprite::BlitScreen",
+		"Weather::Draw",
+		"Transition::Draw",
+		"GenericAudio::Decode"
+	};
+
+	// Nanoseconds and passes per zone since the last TakeZoneTimes
+	std::atomic<int64_t> zone_times[Profiler::Zone_Count];
+	std::atomic<uint32_t> zone_calls[Profiler::Zone_Count];
+
+	clock::time_point epoch = clock::now();
+	std::thread::id main_thread = std::this_thread::get_id();
+
+	std::atomic<bool> trace_enabled(false);
+	std::mutex trace_mutex;
+	std::shared_ptr<std::ostream> trace_file;
+	bool trace_first_event = true;
+
+	double ToMicroseconds(clock::duration d) {
+		return std::chrono::duration<double, std::micro>(d).count();
+	}
+
+	void WriteTraceEvent(Profiler::Zone zone, clock::time_point start, clock::time_point end) {
+		// Main thread is 1, everything else (audio) is 2
+		int tid = std::this_thread::get_id() == main_thread ? 1 : 2;
+
+		std::lock_guard<std::mutex> lock(trace_mutex);
+		if (!trace_file) {
+			return;
+		}
+
+		*trace_file << (trace_first_event ? "\n" : ",\n")
+			<< R"({"name":")" << zone_names[zone]
+			<< R"(","ph":"X","pid":1,"tid":)" << tid
+			<< R"(,"ts":)" << ToMicroseconds(start - epoch)
+			<< R"(,"dur":)" << ToMicroseconds(end - start) << "}";
+		trace_first_event = false;
+	}
+}
+
+void Profiler::Init(const std::string& trace_path) {
+	epoch = clock::now();
+	main_thread = std::this_thread::get_id();
+
+	for (auto& t : zone_times) {
+		t = 0;
+	}
+	for (auto& c : zone_calls) {
+		c = 0;
+	}
+
+	if (trace_path.empty()) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(trace_mutex);
+	trace_file = FileFinder::openUTF8(trace_path, std::ios::out | std::ios::trunc);
+	if (!trace_file) {
+		Output::Warning("Profiler: Could not open %s for writing", trace_path.c_str());
+		return;
+	}
+
+	Output::Debug("Profiler: Writing trace events to %s", trace_path.c_str());
+	*trace_file << std::fixed;
+	*trace_file << R"({"displayTimeUnit":"ms","traceEvents":[)";
+	trace_first_event = true;
+	trace_enabled = true;
+}
+
+void Profiler::Quit() {
+	trace_enabled = false;
+
+	std::lock_guard<std::mutex> lock(trace_mutex);
+	if (trace_file) {
+		*trace_file << "\n]}\n";
+		trace_file.reset();
+	}
+}
+
+const char* Profiler::GetZoneName(Zone zone) {
+	return zone_names[zone];
+}
+
+Profiler::ZoneTimes Profiler::TakeZoneTimes() {
+	ZoneTimes times;
+	for (int i = 0; i < Zone_Count; ++i) {
+		// Not atomic together, a pass finishing in between is off by one
+		const uint32_t calls = zone_calls[i].exchange(0);
+		const int64_t time = zone_times[i].exchange(0);
+		times[i] = calls > 0 ? time / 1000.0 / calls : 0.0;
+	}
+	return times;
+}
+
+Profiler::ScopedZone::ScopedZone(Zone zone) :
+	zone(zone), start(clock::now()) {
+}
+
+Profiler::ScopedZone::~ScopedZone() {
+	clock::time_point end = clock::now();
+
+	zone_times[zone] += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+	++zone_calls[zone];
+
+	if (trace_enabled) {
+		WriteTraceEvent(zone, start, end);
+	}
+}
+
+#endif
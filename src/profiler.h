@@ -0,0 +1,103 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_PROFILER_H
+#define EP_PROFILER_H
+
+// Headers
+#include <array>
+#include <chrono>
+#include <string>
+#include "system.h"
+
+/**
+ * Profiler namespace.
+ * Measures the time spent in hot code paths ("zones"). The per-zone times
+ * are shown by the FpsOverlay and can be written to a Chrome trace-event
+ * file (chrome://tracing, Perfetto).
+ *
+ * Only available when compiled with ENABLE_PROFILER, otherwise
+ * EP_PROFILE_ZONE expands to nothing.
+ */
+namespace Profiler {
+	/** Instrumented code paths */
+	enum Zone {
+		Zone_MapUpdate,
+		Zone_InterpreterUpdate,
+		Zone_TilemapDraw,
+		Zone_SpriteBlit,
+		Zone_WeatherDraw,
+		Zone_TransitionDraw,
+		Zone_AudioDecode,
+		Zone_Count
+	};
+
+	using ZoneTimes = std::array<double, Zone_Count>;
+
+	/**
+	 * Initializes the profiler.
+	 *
+	 * @param trace_path file to write trace events to, empty to disable
+	 */
+	void Init(const std::string& trace_path);
+
+	/**
+	 * Finishes and closes the trace file.
+	 */
+	void Quit();
+
+	/**
+	 * @param zone zone
+	 * @return human readable name of the zone
+	 */
+	const char* GetZoneName(Zone zone);
+
+	/**
+	 * Returns the average time of one pass through every zone since the
+	 * last call and resets the counters. Zones run at different rates
+	 * (updates, frames, audio callbacks), so each is averaged over its own
+	 * number of passes. Nested zones are included in their parent.
+	 *
+	 * @return time per zone pass in microseconds, 0 for zones not entered
+	 */
+	ZoneTimes TakeZoneTimes();
+
+	/**
+	 * Measures the time between construction and destruction.
+	 * Thread-safe, the audio thread uses it, too.
+	 */
+	class ScopedZone {
+	public:
+		explicit ScopedZone(Zone zone);
+		~ScopedZone();
+
+		ScopedZone(const ScopedZone&) = delete;
+		ScopedZone& operator=(const ScopedZone&) = delete;
+
+	private:
+		Zone zone;
+		std::chrono::steady_clock::time_point start;
+	};
+}
+
+#ifdef ENABLE_PROFILER
+#  define EP_PROFILE_ZONE(zone) Profiler::ScopedZone ep_profile_zone(Profiler::zone)
+#else
+#  define EP_PROFILE_ZONE(zone)
+#endif
+
+#endif
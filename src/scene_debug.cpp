@@ -75,6 +75,7 @@ void Scene_Debug::Start() {
 	CreateRangeWindow();
 	CreateVarListWindow();
 	CreateNumberInputWindow();
+	CreateCacheWindow();
 
 	range_index = prev.main_range_index;
 	range_window->SetIndex(range_index);
@@ -85,6 +86,8 @@ void Scene_Debug::Start() {
 }
 
 void Scene_Debug::Update() {
+	UpdateCacheWindow();
+
 	range_window->Update();
 	if (range_index != range_window->GetIndex()){
 		range_index = range_window->GetIndex();
@@ -606,6 +609,29 @@ void Scene_Debug::CreateNumberInputWindow() {
 	numberinput_window->SetShowOperator(true);
 }
 
+void Scene_Debug::CreateCacheWindow() {
+	cache_window.reset(new Window_Help(0, 0, SCREEN_TARGET_WIDTH, 32));
+	UpdateCacheWindow(true);
+}
+
+void Scene_Debug::UpdateCacheWindow(bool force) {
+	Cache::Stats stats = Cache::GetStats();
+	if (!force && stats.hits == cache_stats.hits && stats.misses == cache_stats.misses &&
+		stats.evictions == cache_stats.evictions && stats.size == cache_stats.size) {
+		return;
+	}
+	cache_stats = stats;
+
+	std::stringstream ss;
+	ss << "Cache " << std::fixed << std::setprecision(1)
+		<< (stats.size / 1024.0 / 1024.0) << "/"
+		<< (stats.limit / 1024.0 / 1024.0) << "MB"
+		<< " Hit " << stats.hits
+		<< " Miss " << stats.misses
+		<< " Evict " << stats.evictions;
+	cache_window->SetText(ss.str());
+}
+
 int Scene_Debug::GetIndex() {
 	return (range_page * 100 + range_index * 10 + var_window->GetIndex() + 1);
 }
@@ -20,8 +20,10 @@
 
 // Headers
 #include <vector>
+#include "cache.h"
 #include "scene.h"
 #include "window_command.h"
+#include "window_help.h"
 #include "window_numberinput.h"
 #include "window_varlist.h"
 
@@ -95,6 +97,16 @@ private:
 	/** Creates number input window. */
 	void CreateNumberInputWindow();
 
+	/** Creates the bitmap cache statistics window. */
+	void CreateCacheWindow();
+
+	/**
+	 * Updates the bitmap cache statistics when they changed.
+	 *
+	 * @param force refresh even when unchanged
+	 */
+	void UpdateCacheWindow(bool force = false);
+
 	/** Get the last page for the current mode */
 	int GetLastPage();
 
@@ -104,6 +116,11 @@ private:
 	std::unique_ptr<Window_VarList> var_window;
 	/** Number Editor. */
 	std::unique_ptr<Window_NumberInput> numberinput_window;
+	/** Displays the bitmap cache statistics. */
+	std::unique_ptr<Window_Help> cache_window;
+
+	/** Statistics shown in the cache window */
+	Cache::Stats cache_stats;
 
 	int pending_map_id = 0;
 	int pending_map_x = 0;
@@ -57,3 +57,12 @@ void Screen::Draw() {
 		disp->Blit(0, 0, *flash, flash->GetRect(), 255);
 	}
 }
+
+bool Screen::GetDrawState(DrawState& state) {
+	auto flash_color = Main_Data::game_screen->GetFlashColor();
+	if (flash_color.alpha > 0) {
+		state.rect = Rect(0, 0, SCREEN_TARGET_WIDTH, SCREEN_TARGET_HEIGHT);
+		state.Add(flash_color);
+	}
+	return true;
+}
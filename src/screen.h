@@ -38,6 +38,7 @@ public:
 	~Screen() override;
 
 	void Draw() override;
+	bool GetDrawState(DrawState& state) override;
 	void Update();
 
 	int GetZ() const override;
@@ -270,6 +270,8 @@ bool Sdl2Ui::RefreshDisplayMode() {
 
 		if (!sdl_texture)
 			return false;
+
+		texture_needs_upload = true;
 	} else {
 		// Browser handles fast resizing for emscripten, TODO: use fullscreen API
 #ifndef EMSCRIPTEN
@@ -400,7 +402,21 @@ void Sdl2Ui::ProcessEvents() {
 }
 
 void Sdl2Ui::UpdateDisplay() {
-	SDL_UpdateTexture(sdl_texture, NULL, main_surface->pixels(), main_surface->pitch());
+	if (!TakeDisplayDamage(texture_damage) || texture_needs_upload) {
+		SDL_UpdateTexture(sdl_texture, NULL, main_surface->pixels(), main_surface->pitch());
+		texture_needs_upload = false;
+	} else {
+		// Only upload the areas that changed
+		const uint8_t* pixels = static_cast<const uint8_t*>(main_surface->pixels());
+		int pitch = main_surface->pitch();
+		int bpp = main_surface->bpp();
+
+		for (const auto& rect : texture_damage) {
+			SDL_Rect sdl_rect = { rect.x, rect.y, rect.width, rect.height };
+			SDL_UpdateTexture(sdl_texture, &sdl_rect, pixels + rect.y * pitch + rect.x * bpp, pitch);
+		}
+	}
+
 	SDL_RenderClear(sdl_renderer);
 	SDL_RenderCopy(sdl_renderer, sdl_texture, NULL, NULL);
 	SDL_RenderPresent(sdl_renderer);
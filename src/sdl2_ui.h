@@ -139,6 +139,12 @@ private:
 	SDL_Window* sdl_window;
 	SDL_Renderer* sdl_renderer;
 
+	/** Texture contents are undefined, the next UpdateDisplay uploads everything */
+	bool texture_needs_upload = true;
+
+	/** Changed areas of the display surface, reused between frames */
+	std::vector<Rect> texture_damage;
+
 	std::unique_ptr<AudioInterface> audio_;
 };
 
@@ -16,6 +16,7 @@
  */
 
 // Headers
+#include <cmath>
 #include <string>
 #include "sprite.h"
 #include "player.h"
@@ -23,6 +24,7 @@
 #include "util_macro.h"
 #include "bitmap.h"
 #include "cache.h"
+#include "profiler.h"
 
 // Constructor
 Sprite::Sprite() :
@@ -75,7 +77,44 @@ void Sprite::Draw() {
 	BlitScreen();
 }
 
+bool Sprite::GetDrawState(DrawState& state) {
+	if (!visible || GetWidth() <= 0 || GetHeight() <= 0) return true;
+	if (!bitmap || (opacity_top_effect <= 0 && opacity_bottom_effect <= 0)) return true;
+
+	if (waver_effect_depth != 0) {
+		// Every line is shifted by up to 2 * zoom * depth pixels
+		int shift = static_cast<int>(std::ceil(2 * std::abs(zoom_x_effect) * std::abs(waver_effect_depth))) + 1;
+		state.rect = Rect(
+			static_cast<int>(x - ox * zoom_x_effect) - shift,
+			static_cast<int>(y - oy * zoom_y_effect),
+			static_cast<int>(std::floor(GetWidth() * zoom_x_effect)) + 2 * shift,
+			static_cast<int>(std::floor(GetHeight() * zoom_y_effect)));
+	} else if (angle_effect != 0.0) {
+		// Rotated sprites are rare, assume they cover the whole screen
+		state.rect = Rect(0, 0, SCREEN_TARGET_WIDTH, SCREEN_TARGET_HEIGHT);
+	} else if (zoom_x_effect != 1.0 || zoom_y_effect != 1.0) {
+		// One extra pixel against rounding differences of the scaler
+		state.rect = Rect(
+			x - static_cast<int>(std::floor(ox * zoom_x_effect)) - 1,
+			y - static_cast<int>(std::floor(oy * zoom_y_effect)) - 1,
+			static_cast<int>(std::floor(GetWidth() * zoom_x_effect)) + 2,
+			static_cast<int>(std::floor(GetHeight() * zoom_y_effect)) + 2);
+	} else {
+		state.rect = Rect(x - ox, y - oy, GetWidth(), GetHeight());
+	}
+
+	state.Add(bitmap).Add(src_rect).Add(src_rect_effect)
+		.Add(x).Add(y).Add(ox).Add(oy)
+		.Add(opacity_top_effect).Add(opacity_bottom_effect).Add(bush_effect)
+		.Add(tone_effect).Add(flash_effect).Add(flipx_effect).Add(flipy_effect)
+		.Add(zoom_x_effect).Add(zoom_y_effect).Add(angle_effect)
+		.Add(waver_effect_depth).Add(waver_effect_phase);
+	return true;
+}
+
 void Sprite::BlitScreen() {
+	EP_PROFILE_ZONE(Zone_SpriteBlit);
+
 	if (!bitmap || (opacity_top_effect <= 0 && opacity_bottom_effect <= 0))
 		return;
 
@@ -253,8 +292,10 @@ int Sprite::GetZ() const {
 	return z;
 }
 void Sprite::SetZ(int nz) {
-	if (z != nz) Graphics::UpdateZCallback();
-	z = nz;
+	if (z != nz) {
+		z = nz;
+		Graphics::UpdateZCallback(this);
+	}
 }
 
 int Sprite::GetOx() const {
@@ -35,6 +35,8 @@ public:
 
 	void Draw() override;
 
+	bool GetDrawState(DrawState& state) override;
+
 	virtual void Flash(int duration);
 	virtual void Flash(Color color, int duration);
 	void Update();
@@ -48,20 +48,23 @@ void Sprite_Timer::Draw() {
 		return;
 	}
 
-	BitmapRef system = Cache::System(system_name);
+	Sprite::Draw();
+}
 
+void Sprite_Timer::RefreshBitmap() {
 	GetBitmap()->Clear();
+
+	if (bitmap_system.empty()) {
+		return;
+	}
+
+	BitmapRef system = Cache::System(bitmap_system);
 	for (int i = 0; i < 5; ++i) {
-		if (i == 2) { // :
-			int frames =  Main_Data::game_party->GetTimerFrames(which);
-			if (frames % DEFAULT_FPS < DEFAULT_FPS / 2) {
-				continue;
-			}
+		if (i == 2 && !bitmap_colon) {
+			continue;
 		}
 		GetBitmap()->Blit(i * 8, 0, *system, digits[i], Opacity());
 	}
-
-	Sprite::Draw();
 }
 
 void Sprite_Timer::Update() {
@@ -89,6 +92,17 @@ void Sprite_Timer::Update() {
 	digits[3].x = 32 + 8 * secs_10;
 	digits[4].x = 32 + 8 * secs_1;
 
+	// Only redrawn when changed, writing the bitmap damages the timer area
+	const int frames = Main_Data::game_party->GetTimerFrames(which);
+	const bool colon = frames % DEFAULT_FPS >= DEFAULT_FPS / 2;
+	const auto& system_name = Game_System::GetSystemName();
+	if (all_secs != bitmap_seconds || colon != bitmap_colon || system_name != bitmap_system) {
+		bitmap_seconds = all_secs;
+		bitmap_colon = colon;
+		bitmap_system = system_name;
+		RefreshBitmap();
+	}
+
 	if (Game_Temp::battle_running) {
 		SetY(SCREEN_TARGET_HEIGHT / 3 * 2 - 20);
 	}
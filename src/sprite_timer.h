@@ -19,6 +19,7 @@
 #define EP_SPRITE_TIMER_H
 
 // Headers
+#include <string>
 #include "sprite.h"
 
 /**
@@ -44,9 +45,17 @@ protected:
 	void CreateSprite();
 	void Draw() override;
 
+	/** Draws the digits into the bitmap, only called by Update. */
+	void RefreshBitmap();
+
 	int which;
 
 	Rect digits[5];
+
+	/** Seconds, colon state and system graphic shown by the bitmap */
+	int bitmap_seconds = -1;
+	bool bitmap_colon = false;
+	std::string bitmap_system;
 };
 
 #endif
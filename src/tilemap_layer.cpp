@@ -16,6 +16,7 @@
  */
 
 // Headers
+#include <algorithm>
 #include <cstring>
 #include <cmath>
 #include "tilemap_layer.h"
@@ -26,6 +27,7 @@
 #include "bitmap.h"
 #include "game_map.h"
 #include "main_data.h"
+#include "profiler.h"
 
 // Blocks subtiles IDs
 // Mess with this code and you will die in 3 days...
@@ -137,6 +139,16 @@ static const uint8_t BlockD_Subtiles_IDS[50][2][2][2] = {
     {{{0, 0}, {0, 0}}, {{0, 0}, {0, 0}}}
 };
 
+static int div_rounding_down(int n, int m) {
+	if (n >= 0) return n / m;
+	return (n - m + 1) / m;
+}
+
+static int mod(int n, int m) {
+	int rem = n % m;
+	return rem >= 0 ? rem : m + rem;
+}
+
 TilemapLayer::TilemapLayer(int ilayer) :
 	substitutions(ilayer >= 1
 			? Main_Data::game_data.map_info.upper_tiles
@@ -164,25 +176,31 @@ TilemapLayer::TilemapLayer(int ilayer) :
 	sublayers.push_back(std::make_shared<TilemapSubLayer>(this, Priority_TilesetBelow + layer));
 }
 
-void TilemapLayer::DrawTile(Bitmap& screen, int x, int y, int row, int col) {
+void TilemapLayer::DrawTile(Bitmap& dst, Bitmap& screen, int x, int y, int row, int col, bool chunk) {
 	Bitmap::TileOpacity op = screen.GetTileOpacity(row, col);
+	Rect rect(col * TILE_SIZE, row * TILE_SIZE, TILE_SIZE, TILE_SIZE);
 
-	if (!fast_blit && op == Bitmap::Transparent)
+	if (fast_blit && chunk) {
+		// The chunk is blended on the screen. An opaque black background
+		// results in the same colors as copying the tile with BlitFast.
+		dst.FillRect(Rect(x, y, TILE_SIZE, TILE_SIZE), Color(0, 0, 0, 255));
+	} else if (fast_blit) {
+		dst.BlitFast(x, y, screen, rect, 255);
 		return;
-	Rect rect(col * TILE_SIZE, row * TILE_SIZE, TILE_SIZE, TILE_SIZE);
+	}
 
-	BitmapRef dst = DisplayUi->GetDisplaySurface();
+	if (op == Bitmap::Transparent)
+		return;
 
-	if (fast_blit || op == Bitmap::Opaque) {
-		dst->BlitFast(x, y, screen, rect, 255);
+	if (op == Bitmap::Opaque) {
+		dst.BlitFast(x, y, screen, rect, 255);
 	} else {
-		dst->Blit(x, y, screen, rect, 255);
+		dst.Blit(x, y, screen, rect, 255);
 	}
 }
 
-void TilemapLayer::Draw(int z_order) {
-	if (!visible) return;
-
+template <typename F>
+void TilemapLayer::ForEachVisibleTile(F&& f) const {
 	// Get the number of tiles that can be displayed on window
 	int tiles_x = (int)ceil(DisplayUi->GetWidth() / (float)TILE_SIZE);
 	int tiles_y = (int)ceil(DisplayUi->GetHeight() / (float)TILE_SIZE);
@@ -198,16 +216,6 @@ void TilemapLayer::Draw(int z_order) {
 
 	for (int x = 0; x < tiles_x; x++) {
 		for (int y = 0; y < tiles_y; y++) {
-
-			auto div_rounding_down = [](int n, int m) {
-				if (n >= 0) return n / m;
-				return (n - m + 1) / m;
-			};
-			auto mod = [](int n, int m) {
-				int rem = n % m;
-				return rem >= 0 ? rem : m + rem;
-			};
-
 			// Get the real maps tile coordinates
 			int map_x = div_rounding_down(ox, TILE_SIZE) + x;
 			int map_y = div_rounding_down(oy, TILE_SIZE) + y;
@@ -225,117 +233,323 @@ void TilemapLayer::Draw(int z_order) {
 				continue;
 			}
 
-			// Get the tile data
-			TileData &tile = data_cache[map_x][map_y];
-
-			// Draw the sublayer if its z is being draw now
-			if (z_order == tile.z) {
-				if (layer == 0) {
-					// If lower layer
-
-					if (tile.ID >= BLOCK_E && tile.ID < BLOCK_E + BLOCK_E_TILES) {
-						int id = substitutions[tile.ID - BLOCK_E];
-						// If Block E
-
-						int row, col;
-
-						// Get the tile coordinates from chipset
-						if (id < 96) {
-							// If from first column of the block
-							col = 12 + id % 6;
-							row = id / 6;
-						} else {
-							// If from second column of the block
-							col = 18 + (id - 96) % 6;
-							row = (id - 96) / 6;
-						}
-
-						// Create tone changed tile
-						if (chipset_tone_tiles.find(id) == chipset_tone_tiles.end()) {
-							Rect r(col * TILE_SIZE, row * TILE_SIZE, TILE_SIZE, TILE_SIZE);
-							chipset_effect->ToneBlit(col * TILE_SIZE, row * TILE_SIZE, *chipset, r, tone, Opacity::opaque);
-							chipset_tone_tiles.insert(id);
-						}
-
-						DrawTile(*chipset_effect, map_draw_x, map_draw_y, row, col);
-					} else if (tile.ID >= BLOCK_C && tile.ID < BLOCK_D) {
-						// If Block C
-
-						// Get the tile coordinates from chipset
-						int col = 3 + (tile.ID - BLOCK_C) / 50;
-						int row = 4 + animation_step_c;
-
-						// Create tone changed tile
-						if (chipset_tone_tiles.find(tile.ID + (animation_step_c << 12)) == chipset_tone_tiles.end()) {
-							Rect r(col * TILE_SIZE, row * TILE_SIZE, TILE_SIZE, TILE_SIZE);
-							chipset_effect->ToneBlit(col * TILE_SIZE, row * TILE_SIZE, *chipset, r, tone, Opacity::opaque);
-							chipset_tone_tiles.insert(tile.ID + (animation_step_c << 12));
-						}
-
-						// Draw the tile
-						DrawTile(*chipset_effect, map_draw_x, map_draw_y, row, col);
-					} else if (tile.ID < BLOCK_C) {
-						// If Blocks A1, A2, B
-
-						// Draw the tile from autotile cache
-						TileXY pos = GetCachedAutotileAB(tile.ID, animation_step_ab);
-
-						// Create tone changed tile
-						if (autotiles_ab_screen_tone_tiles.find(tile.ID + (animation_step_ab << 12)) == autotiles_ab_screen_tone_tiles.end()) {
-							Rect r(pos.x * TILE_SIZE, pos.y * TILE_SIZE, TILE_SIZE, TILE_SIZE);
-							autotiles_ab_screen_effect->ToneBlit(pos.x * TILE_SIZE, pos.y * TILE_SIZE, *autotiles_ab_screen, r, tone, Opacity::opaque);
-							autotiles_ab_screen_tone_tiles.insert(tile.ID + (animation_step_ab << 12));
-						}
-
-						DrawTile(*autotiles_ab_screen_effect, map_draw_x, map_draw_y, pos.y, pos.x);
-					} else {
-						// If blocks D1-D12
-
-						// Draw the tile from autotile cache
-						TileXY pos = GetCachedAutotileD(tile.ID);
-
-						// Create tone changed tile
-						if (autotiles_d_screen_tone_tiles.find(tile.ID) == autotiles_d_screen_tone_tiles.end()) {
-							Rect r(pos.x * TILE_SIZE, pos.y * TILE_SIZE, TILE_SIZE, TILE_SIZE);
-							autotiles_d_screen_effect->ToneBlit(pos.x * TILE_SIZE, pos.y * TILE_SIZE, *autotiles_d_screen, r, tone, Opacity::opaque);
-							autotiles_d_screen_tone_tiles.insert(tile.ID);
-						}
-
-						DrawTile(*autotiles_d_screen_effect, map_draw_x, map_draw_y, pos.y, pos.x);
-					}
-				} else {
-					// If upper layer
-
-					// Check that block F is being drawn
-					if (tile.ID >= BLOCK_F && tile.ID < BLOCK_F + BLOCK_F_TILES) {
-						int id = substitutions[tile.ID - BLOCK_F];
-						int row, col;
-
-						// Get the tile coordinates from chipset
-						if (id < 48) {
-							// If from first column of the block
-							col = 18 + id % 6;
-							row = 8 + id / 6;
-						} else {
-							// If from second column of the block
-							col = 24 + (id - 48) % 6;
-							row = (id - 48) / 6;
-						}
-
-						// Create tone changed tile
-						if (chipset_tone_tiles.find(id) == chipset_tone_tiles.end()) {
-							Rect r(col * TILE_SIZE, row * TILE_SIZE, TILE_SIZE, TILE_SIZE);
-							chipset_effect->ToneBlit(col * TILE_SIZE, row * TILE_SIZE, *chipset, r, tone, Opacity::opaque);
-							chipset_tone_tiles.insert(id);
-						}
-
-						// Draw the tile
-						DrawTile(*chipset_effect, map_draw_x, map_draw_y, row, col);
-					}
+			f(map_x, map_y, map_draw_x, map_draw_y);
+		}
+	}
+}
+
+void TilemapLayer::Draw(int z_order) {
+	EP_PROFILE_ZONE(Zone_TilemapDraw);
+
+	if (!visible) return;
+
+	BitmapRef dst = DisplayUi->GetDisplaySurface();
+
+	// Static tiles are drawn from the chunks, only the animated ones per tile
+	bool use_chunks = chunk_stable_frames >= CHUNK_STABLE_FRAMES;
+	if (use_chunks) {
+		DrawChunks(*dst, z_order);
+	}
+
+	ForEachVisibleTile([&](int map_x, int map_y, int map_draw_x, int map_draw_y) {
+		// Get the tile data
+		const TileData& tile = data_cache[map_x][map_y];
+
+		// Draw the sublayer if its z is being draw now
+		if (z_order == tile.z && (!use_chunks || IsAnimatedTile(tile))) {
+			DrawTileData(*dst, tile, map_draw_x, map_draw_y, false);
+		}
+	});
+}
+
+void TilemapLayer::DrawTileData(Bitmap& dst, const TileData& tile, int map_draw_x, int map_draw_y, bool chunk) {
+	if (layer == 0) {
+		// If lower layer
+
+		if (tile.ID >= BLOCK_E && tile.ID < BLOCK_E + BLOCK_E_TILES) {
+			int id = substitutions[tile.ID - BLOCK_E];
+			// If Block E
+
+			int row, col;
+
+			// Get the tile coordinates from chipset
+			if (id < 96) {
+				// If from first column of the block
+				col = 12 + id % 6;
+				row = id / 6;
+			} else {
+				// If from second column of the block
+				col = 18 + (id - 96) % 6;
+				row = (id - 96) / 6;
+			}
+
+			// Create tone changed tile
+			ToneTile(*chipset_effect, *chipset, chipset_tone_tiles, row, col);
+
+			DrawTile(dst, *chipset_effect, map_draw_x, map_draw_y, row, col, chunk);
+		} else if (tile.ID >= BLOCK_C && tile.ID < BLOCK_D) {
+			// If Block C
+
+			// Get the tile coordinates from chipset
+			int col = 3 + (tile.ID - BLOCK_C) / 50;
+			int row = 4 + animation_step_c;
+
+			// Create tone changed tile
+			ToneTile(*chipset_effect, *chipset, chipset_tone_tiles, row, col);
+
+			// Draw the tile
+			DrawTile(dst, *chipset_effect, map_draw_x, map_draw_y, row, col, chunk);
+		} else if (tile.ID < BLOCK_C) {
+			// If Blocks A1, A2, B
+
+			// Draw the tile from autotile cache
+			TileXY pos = GetCachedAutotileAB(tile.ID, animation_step_ab);
+
+			// Create tone changed tile
+			ToneTile(*autotiles_ab_screen_effect, *autotiles_ab_screen, autotiles_ab_screen_tone_tiles, pos.y, pos.x);
+
+			DrawTile(dst, *autotiles_ab_screen_effect, map_draw_x, map_draw_y, pos.y, pos.x, chunk);
+		} else {
+			// If blocks D1-D12
+
+			// Draw the tile from autotile cache
+			TileXY pos = GetCachedAutotileD(tile.ID);
+
+			// Create tone changed tile
+			ToneTile(*autotiles_d_screen_effect, *autotiles_d_screen, autotiles_d_screen_tone_tiles, pos.y, pos.x);
+
+			DrawTile(dst, *autotiles_d_screen_effect, map_draw_x, map_draw_y, pos.y, pos.x, chunk);
+		}
+	} else {
+		// If upper layer
+
+		// Check that block F is being drawn
+		if (tile.ID >= BLOCK_F && tile.ID < BLOCK_F + BLOCK_F_TILES) {
+			int id = substitutions[tile.ID - BLOCK_F];
+			int row, col;
+
+			// Get the tile coordinates from chipset
+			if (id < 48) {
+				// If from first column of the block
+				col = 18 + id % 6;
+				row = 8 + id / 6;
+			} else {
+				// If from second column of the block
+				col = 24 + (id - 48) % 6;
+				row = (id - 48) / 6;
+			}
+
+			// Create tone changed tile
+			ToneTile(*chipset_effect, *chipset, chipset_tone_tiles, row, col);
+
+			// Draw the tile
+			DrawTile(dst, *chipset_effect, map_draw_x, map_draw_y, row, col, chunk);
+		}
+	}
+}
+
+void TilemapLayer::ToneTile(Bitmap& effect, Bitmap& source, std::vector<bool>& toned, int row, int col) {
+	int columns = source.width() / TILE_SIZE;
+	if (toned.empty()) {
+		toned.resize(columns * (source.height() / TILE_SIZE));
+	}
+
+	int index = row * columns + col;
+	if (toned[index]) {
+		return;
+	}
+
+	Rect r(col * TILE_SIZE, row * TILE_SIZE, TILE_SIZE, TILE_SIZE);
+	effect.ToneBlit(col * TILE_SIZE, row * TILE_SIZE, source, r, tone, Opacity::opaque);
+	toned[index] = true;
+}
+
+void TilemapLayer::ToneAllTiles() {
+	auto tone_sheet = [&](Bitmap* effect, Bitmap* source, std::vector<bool>& toned) {
+		if (!effect || !source) {
+			return;
+		}
+		if (!toned.empty() && std::find(toned.begin(), toned.end(), false) == toned.end()) {
+			return;
+		}
+
+		// ToneBlit blends, tiles toned before must not be toned twice
+		effect->Clear();
+		effect->ToneBlit(0, 0, *source, source->GetRect(), tone, Opacity::opaque);
+		toned.assign((source->width() / TILE_SIZE) * (source->height() / TILE_SIZE), true);
+	};
+
+	tone_sheet(chipset_effect.get(), chipset.get(), chipset_tone_tiles);
+	tone_sheet(autotiles_ab_screen_effect.get(), autotiles_ab_screen.get(), autotiles_ab_screen_tone_tiles);
+	tone_sheet(autotiles_d_screen_effect.get(), autotiles_d_screen.get(), autotiles_d_screen_tone_tiles);
+}
+
+bool TilemapLayer::IsAnimatedTile(const TileData& tile) const {
+	// Blocks A1, A2, B and C
+	return layer == 0 && tile.ID < BLOCK_D;
+}
+
+void TilemapLayer::GetTileSpans(int offset, int screen_size, int map_size, bool loop, std::vector<TileSpan>& spans) {
+	spans.clear();
+
+	// Same tiles as in TilemapLayer::ForEachVisibleTile
+	int tiles = (int)ceil(screen_size / (float)TILE_SIZE);
+	if (offset % TILE_SIZE != 0) {
+		++tiles;
+	}
+
+	for (int i = 0; i < tiles; ++i) {
+		int map_pos = div_rounding_down(offset, TILE_SIZE) + i;
+		if (loop) map_pos = mod(map_pos, map_size);
+
+		if (map_pos < 0 || map_pos >= map_size) {
+			continue;
+		}
+
+		int screen_pos = i * TILE_SIZE - mod(offset, TILE_SIZE);
+
+		if (!spans.empty()) {
+			TileSpan& span = spans.back();
+			if (span.map_start + span.count == map_pos &&
+				span.screen_start + span.count * TILE_SIZE == screen_pos &&
+				map_pos % CHUNK_SIZE != 0) {
+				++span.count;
+				continue;
+			}
+		}
+
+		spans.push_back({map_pos, screen_pos, 1});
+	}
+}
+
+void TilemapLayer::DrawChunks(Bitmap& dst, int z_order) {
+	ChunkCache& cache = z_order == Priority_TilesetAbove + layer ? chunks_above : chunks_below;
+	++cache.draw_count;
+
+	GetTileSpans(ox, DisplayUi->GetWidth(), width, Game_Map::LoopHorizontal(), chunk_spans_x);
+	GetTileSpans(oy, DisplayUi->GetHeight(), height, Game_Map::LoopVertical(), chunk_spans_y);
+
+	for (const TileSpan& span_y : chunk_spans_y) {
+		for (const TileSpan& span_x : chunk_spans_x) {
+			int chunk_x = span_x.map_start / CHUNK_SIZE;
+			int chunk_y = span_y.map_start / CHUNK_SIZE;
+			Chunk& chunk = cache.chunks[chunk_x + chunk_y * chunks_width];
+
+			if (!chunk.valid || chunk.fast_blit != fast_blit) {
+				RenderChunk(cache, z_order, chunk_x, chunk_y);
+			}
+			chunk.last_used = cache.draw_count;
+
+			Rect rect((span_x.map_start - chunk_x * CHUNK_SIZE) * TILE_SIZE,
+				(span_y.map_start - chunk_y * CHUNK_SIZE) * TILE_SIZE,
+				span_x.count * TILE_SIZE,
+				span_y.count * TILE_SIZE);
+			dst.Blit(span_x.screen_start, span_y.screen_start, *chunk.bitmap, rect, 255);
+		}
+	}
+}
+
+void TilemapLayer::RenderChunk(ChunkCache& cache, int z_order, int chunk_x, int chunk_y) {
+	int index = chunk_x + chunk_y * chunks_width;
+	Chunk& chunk = cache.chunks[index];
+
+	// Chunks are rendered when the tone is stable, most tiles are needed
+	ToneAllTiles();
+
+	if (chunk.bitmap) {
+		chunk.bitmap->Clear();
+	} else {
+		if ((int)cache.rendered.size() >= MAX_CACHED_CHUNKS) {
+			// Release the least recently used chunk not drawn in this frame
+			auto lru = cache.rendered.end();
+			for (auto it = cache.rendered.begin(); it != cache.rendered.end(); ++it) {
+				const Chunk& other = cache.chunks[*it];
+				if (other.last_used != cache.draw_count &&
+					(lru == cache.rendered.end() || other.last_used < cache.chunks[*lru].last_used)) {
+					lru = it;
 				}
 			}
+			if (lru != cache.rendered.end()) {
+				cache.chunks[*lru] = Chunk();
+				cache.rendered.erase(lru);
+			}
+		}
+
+		chunk.bitmap = Bitmap::Create(CHUNK_SIZE * TILE_SIZE, CHUNK_SIZE * TILE_SIZE, true);
+		cache.rendered.push_back(index);
+	}
+
+	int end_x = std::min((chunk_x + 1) * CHUNK_SIZE, width);
+	int end_y = std::min((chunk_y + 1) * CHUNK_SIZE, height);
+	for (int map_y = chunk_y * CHUNK_SIZE; map_y < end_y; ++map_y) {
+		for (int map_x = chunk_x * CHUNK_SIZE; map_x < end_x; ++map_x) {
+			const TileData& tile = data_cache[map_x][map_y];
+			if (z_order != tile.z || IsAnimatedTile(tile)) {
+				continue;
+			}
+
+			DrawTileData(*chunk.bitmap, tile,
+				(map_x - chunk_x * CHUNK_SIZE) * TILE_SIZE,
+				(map_y - chunk_y * CHUNK_SIZE) * TILE_SIZE, true);
+		}
+	}
+
+	chunk.valid = true;
+	chunk.fast_blit = fast_blit;
+}
+
+void TilemapLayer::InvalidateChunks() {
+	chunk_stable_frames = 0;
+
+	int new_chunks_width = (width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+	size_t new_chunks_count = new_chunks_width * ((height + CHUNK_SIZE - 1) / CHUNK_SIZE);
+
+	for (ChunkCache* cache : { &chunks_below, &chunks_above }) {
+		if (chunks_width != new_chunks_width || cache->chunks.size() != new_chunks_count) {
+			// The map size changed
+			cache->chunks.assign(new_chunks_count, Chunk());
+			cache->rendered.clear();
+		} else {
+			for (int index : cache->rendered) {
+				cache->chunks[index].valid = false;
+			}
 		}
 	}
+	chunks_width = new_chunks_width;
+}
+
+void TilemapLayer::GetDrawState(DrawState& state) {
+	if (!visible) return;
+
+	state.rect = Rect(0, 0, DisplayUi->GetWidth(), DisplayUi->GetHeight());
+	state.Add(chipset).Add(tiles_revision).Add(tone).Add(fast_blit)
+		.Add(ox).Add(oy).Add(width).Add(height)
+		.Add(Game_Map::LoopHorizontal()).Add(Game_Map::LoopVertical());
+}
+
+void TilemapLayer::UpdateAnimationDamage(int z_order, int& step_ab, int& step_c, std::vector<Rect>& damage) {
+	bool ab_changed = step_ab != animation_step_ab;
+	bool c_changed = step_c != animation_step_c;
+	step_ab = animation_step_ab;
+	step_c = animation_step_c;
+
+	// Only the lower layer has animated tiles
+	if (!visible || layer != 0 || (!ab_changed && !c_changed)) return;
+
+	DrawState area;
+	ForEachVisibleTile([&](int map_x, int map_y, int map_draw_x, int map_draw_y) {
+		const TileData& tile = data_cache[map_x][map_y];
+		if (z_order != tile.z) return;
+
+		bool animated =
+			(ab_changed && tile.ID < BLOCK_C) ||
+			(c_changed && tile.ID >= BLOCK_C && tile.ID < BLOCK_D);
+		if (animated) {
+			area.Cover(Rect(map_draw_x, map_draw_y, TILE_SIZE, TILE_SIZE));
+		}
+	});
+
+	damage.push_back(area.rect);
 }
 
 TilemapLayer::TileXY TilemapLayer::GetCachedAutotileAB(short ID, short animID) {
@@ -352,6 +566,8 @@ TilemapLayer::TileXY TilemapLayer::GetCachedAutotileD(short ID) {
 }
 
 void TilemapLayer::CreateTileCache(const std::vector<short>& nmap_data) {
+	++tiles_revision;
+	InvalidateChunks();
 	data_cache.resize(width);
 	for (int x = 0; x < width; x++) {
 		data_cache[x].resize(height);
@@ -590,6 +806,10 @@ BitmapRef TilemapLayer::GenerateAutotiles(int count, const std::map<uint32_t, Ti
 void TilemapLayer::Update() {
 	animation_frame += 1;
 
+	if (chunk_stable_frames < CHUNK_STABLE_FRAMES) {
+		++chunk_stable_frames;
+	}
+
 	// Step to the next animation frame
 	if (animation_frame % 6 == 0) {
 		animation_step_c = (animation_step_c + 1) % 4;
@@ -618,6 +838,8 @@ BitmapRef const& TilemapLayer::GetChipset() const {
 }
 
 void TilemapLayer::SetChipset(BitmapRef const& nchipset) {
+	++tiles_revision;
+	InvalidateChunks();
 	chipset = nchipset;
 	chipset_effect = Bitmap::Create(chipset->width(), chipset->height());
 	chipset_tone_tiles.clear();
@@ -774,6 +996,26 @@ void TilemapSubLayer::Draw() {
 	tilemap->Draw(GetZ());
 }
 
+bool TilemapSubLayer::GetDrawState(DrawState& state) {
+	if (tilemap->GetChipset()) {
+		tilemap->GetDrawState(state);
+	}
+	return true;
+}
+
+bool TilemapSubLayer::UpdateDamage(std::vector<Rect>& damage) {
+	if (!Drawable::UpdateDamage(damage)) {
+		return false;
+	}
+
+	// Animated tiles are not part of the draw state to avoid redrawing
+	// the whole map every animation step
+	if (tilemap->GetChipset()) {
+		tilemap->UpdateAnimationDamage(GetZ(), animation_step_ab, animation_step_c, damage);
+	}
+	return true;
+}
+
 int TilemapSubLayer::GetZ() const {
 	return z;
 }
@@ -788,6 +1030,7 @@ void TilemapLayer::SetTone(Tone tone) {
 	}
 
 	this->tone = tone;
+	InvalidateChunks();
 
 	if (autotiles_d_screen_effect) {
 		autotiles_d_screen_effect->Clear();
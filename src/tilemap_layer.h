@@ -21,7 +21,6 @@
 // Headers
 #include <vector>
 #include <map>
-#include <set>
 #include "system.h"
 #include "drawable.h"
 #include "tone.h"
@@ -38,6 +37,9 @@ public:
 
 	void Draw() override;
 
+	bool GetDrawState(DrawState& state) override;
+	bool UpdateDamage(std::vector<Rect>& damage) override;
+
 	int GetZ() const override;
 
 	DrawableType GetType() const override;
@@ -46,6 +48,10 @@ private:
 	DrawableType type;
 	TilemapLayer* tilemap;
 	int z;
+
+	/** Animation steps of the last drawn frame */
+	int animation_step_ab = -1;
+	int animation_step_c = -1;
 };
 
 /**
@@ -55,9 +61,38 @@ class TilemapLayer {
 public:
 	TilemapLayer(int ilayer);
 
-	void DrawTile(Bitmap& screen, int x, int y, int row, int col);
+	/**
+	 * Draws a tile of a tile sheet.
+	 *
+	 * @param dst destination bitmap
+	 * @param screen tile sheet
+	 * @param x destination x
+	 * @param y destination y
+	 * @param row tile row in the sheet
+	 * @param col tile column in the sheet
+	 * @param chunk whether dst is a chunk that is blended on the screen later
+	 */
+	void DrawTile(Bitmap& dst, Bitmap& screen, int x, int y, int row, int col, bool chunk);
 	void Draw(int z_order);
 
+	/**
+	 * Describes what Draw renders, without the tile animation.
+	 *
+	 * @param state receives the draw state
+	 */
+	void GetDrawState(DrawState& state);
+
+	/**
+	 * Adds the screen area of the animated tiles of a sublayer when the
+	 * animation advanced since the passed animation steps.
+	 *
+	 * @param z_order z of the sublayer
+	 * @param step_ab autotile animation step drawn last, is updated
+	 * @param step_c water animation step drawn last, is updated
+	 * @param damage list receiving the changed area
+	 */
+	void UpdateAnimationDamage(int z_order, int& step_ab, int& step_c, std::vector<Rect>& damage);
+
 	void Update();
 
 	BitmapRef const& GetChipset() const;
@@ -95,7 +130,8 @@ public:
 private:
 	BitmapRef chipset;
 	BitmapRef chipset_effect;
-	std::set<short> chipset_tone_tiles;
+	/** Tone changed tiles of chipset_effect, indexed by row * columns + column */
+	std::vector<bool> chipset_tone_tiles;
 
 	std::vector<short> map_data;
 	std::vector<uint8_t> passable;
@@ -115,6 +151,13 @@ private:
 	bool fast_blit = false;
 
 	void CreateTileCache(const std::vector<short>& nmap_data);
+
+	/** Calls f(map_x, map_y, screen_x, screen_y) for every tile on the screen */
+	template <typename F>
+	void ForEachVisibleTile(F&& f) const;
+
+	/** Changes when the tile data or the chipset changes */
+	int tiles_revision = 0;
 	void GenerateAutotileAB(short ID, short animID);
 	void GenerateAutotileD(short ID);
 
@@ -134,10 +177,10 @@ private:
 	TileXY GetCachedAutotileD(short ID);
 	BitmapRef autotiles_ab_screen;
 	BitmapRef autotiles_ab_screen_effect;
-	std::set<short> autotiles_ab_screen_tone_tiles;
+	std::vector<bool> autotiles_ab_screen_tone_tiles;
 	BitmapRef autotiles_d_screen;
 	BitmapRef autotiles_d_screen_effect;
-	std::set<short> autotiles_d_screen_tone_tiles;
+	std::vector<bool> autotiles_d_screen_tone_tiles;
 
 	int autotiles_ab_next = -1;
 	int autotiles_d_next = -1;
@@ -155,6 +198,73 @@ private:
 	std::vector<std::vector<TileData> > data_cache;
 	std::vector<std::shared_ptr<TilemapSubLayer> > sublayers;
 
+	/** Draws a tile, creates the tone changed tile when needed */
+	void DrawTileData(Bitmap& dst, const TileData& tile, int map_draw_x, int map_draw_y, bool chunk);
+
+	/**
+	 * Creates the tone changed tile in the effect bitmap unless done already.
+	 * Clearing the toned list marks all tiles as not tone changed.
+	 */
+	void ToneTile(Bitmap& effect, Bitmap& source, std::vector<bool>& toned, int row, int col);
+
+	/** Tone changes all remaining tiles in one pass per tile sheet */
+	void ToneAllTiles();
+
+	/** @return whether the tile changes with the autotile animation */
+	bool IsAnimatedTile(const TileData& tile) const;
+
+	/** Width and height of a chunk in tiles */
+	static const int CHUNK_SIZE = 16;
+	/** Rendered chunks kept per sublayer */
+	static const int MAX_CACHED_CHUNKS = 12;
+	/**
+	 * Frames without invalidation before chunks are used.
+	 * Avoids rendering the chunks every frame during a tone change.
+	 */
+	static const int CHUNK_STABLE_FRAMES = 2;
+
+	/** Pre-rendered static tiles of a CHUNK_SIZE x CHUNK_SIZE map area */
+	struct Chunk {
+		BitmapRef bitmap;
+		bool valid = false;
+		bool fast_blit = false;
+		/** Draw call of the sublayer the chunk was used last */
+		unsigned last_used = 0;
+	};
+
+	struct ChunkCache {
+		/** All chunks of the map, row major */
+		std::vector<Chunk> chunks;
+		/** Indices of the chunks owning a bitmap */
+		std::vector<int> rendered;
+		unsigned draw_count = 0;
+	};
+
+	ChunkCache chunks_below;
+	ChunkCache chunks_above;
+	int chunks_width = 0;
+	int chunk_stable_frames = 0;
+
+	/** Composites the visible chunks of a sublayer, renders them on demand */
+	void DrawChunks(Bitmap& dst, int z_order);
+	void RenderChunk(ChunkCache& cache, int z_order, int chunk_x, int chunk_y);
+	/** Called when the tiles, the chipset or the tone changed */
+	void InvalidateChunks();
+
+	/** Consecutive visible tiles along one axis, inside the map and inside one chunk */
+	struct TileSpan {
+		int map_start;
+		int screen_start;
+		int count;
+	};
+
+	/** Splits the visible tiles along one axis into spans */
+	static void GetTileSpans(int offset, int screen_size, int map_size, bool loop, std::vector<TileSpan>& spans);
+
+	/** Visible tile spans, reused between frames */
+	std::vector<TileSpan> chunk_spans_x;
+	std::vector<TileSpan> chunk_spans_y;
+
 	Tone tone;
 };
 
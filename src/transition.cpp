@@ -26,6 +26,7 @@
 #include "game_player.h"
 #include "graphics.h"
 #include "main_data.h"
+#include "profiler.h"
 #include "scene.h"
 #include "drawable.h"
 
@@ -146,6 +147,8 @@ void Transition::SetAttributesTransitions() {
 }
 
 void Transition::Draw() {
+	EP_PROFILE_ZONE(Zone_TransitionDraw);
+
 	if (!IsActive())
 		return;
 
@@ -359,6 +362,11 @@ void Transition::Draw() {
 	}
 }
 
+bool Transition::GetDrawState(DrawState&) {
+	// Transitions redraw the whole screen every frame
+	return !IsActive();
+}
+
 void Transition::Update() {
 	if (IsActive()) {
 		//Update current_frame:
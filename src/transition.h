@@ -91,6 +91,9 @@ public:
 	void AppendBefore(Color color, int duration, int iterations);
 
 	void Draw() override;
+
+	bool GetDrawState(DrawState& state) override;
+
 	void Update();
 	bool IsGlobal() const override;
 
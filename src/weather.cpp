@@ -24,6 +24,7 @@
 #include "game_screen.h"
 #include "graphics.h"
 #include "main_data.h"
+#include "profiler.h"
 #include "weather.h"
 
 Weather::Weather() :
@@ -48,6 +49,8 @@ void Weather::Update() {
 }
 
 void Weather::Draw() {
+	EP_PROFILE_ZONE(Zone_WeatherDraw);
+
 	if (Main_Data::game_screen->GetWeatherType() != Game_Screen::Weather_None) {
 		if (!weather_surface) {
 			weather_surface = Bitmap::Create(SCREEN_TARGET_WIDTH, SCREEN_TARGET_HEIGHT);
@@ -119,6 +122,11 @@ static const uint8_t rain_image[] = {
 
 static const int snowflake_visible = 150;
 
+bool Weather::GetDrawState(DrawState&) {
+	// Weather particles move every frame
+	return Main_Data::game_screen->GetWeatherType() == Game_Screen::Weather_None;
+}
+
 void Weather::DrawRain() {
 	if (!rain_bitmap) {
 		rain_bitmap = Bitmap::Create(rain_image, sizeof(rain_image));
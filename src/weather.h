@@ -32,6 +32,7 @@ public:
 	~Weather() override;
 
 	void Draw() override;
+	bool GetDrawState(DrawState& state) override;
 	void Update();
 
 	int GetZ() const override;
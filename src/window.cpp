@@ -187,6 +187,32 @@ void Window::Draw() {
 	}
 }
 
+bool Window::GetDrawState(DrawState& state) {
+	if (!visible) return true;
+	if (width <= 0 || height <= 0) return true;
+	if (x < -width || x > DisplayUi->GetWidth() || y < -height || y > DisplayUi->GetHeight()) return true;
+
+	state.rect = Rect(x, y, width, height);
+
+	bool cursor_visible = windowskin && width >= 16 && height > 16 &&
+		cursor_rect.width > 4 && cursor_rect.height > 4 && animation_frames == 0;
+	if (cursor_visible) {
+		// The cursor is not clipped at the window border
+		state.Cover(Rect(x + cursor_rect.x + border_x, y + cursor_rect.y + border_y, cursor_rect.width, cursor_rect.height));
+		state.Add(cursor_rect).Add(cursor_frame <= 10);
+	}
+
+	state.Add(windowskin).Add(contents).Add(stretch)
+		.Add(x).Add(y).Add(width).Add(height).Add(ox).Add(oy)
+		.Add(border_x).Add(border_y)
+		.Add(opacity).Add(back_opacity).Add(contents_opacity)
+		.Add(animation_frames).Add(static_cast<int>(animation_count))
+		.Add(cursor_visible)
+		.Add(pause && pause_frame > 16 && animation_frames <= 0)
+		.Add(up_arrow).Add(down_arrow);
+	return true;
+}
+
 void Window::RefreshBackground() {
 	background_needs_refresh = false;
 
@@ -450,8 +476,10 @@ int Window::GetZ() const {
 	return z;
 }
 void Window::SetZ(int nz) {
-	if (z != nz) Graphics::UpdateZCallback();
-	z = nz;
+	if (z != nz) {
+		z = nz;
+		Graphics::UpdateZCallback(this);
+	}
 }
 
 int Window::GetOx() const {
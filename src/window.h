@@ -33,6 +33,8 @@ public:
 
 	void Draw() override;
 
+	bool GetDrawState(DrawState& state) override;
+
 	void Update();
 	BitmapRef const& GetWindowskin() const;
 	void SetWindowskin(BitmapRef const& nwindowskin);
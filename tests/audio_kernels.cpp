@@ -0,0 +1,136 @@
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "audio_kernels.h"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+using namespace AudioKernels;
+using Format = AudioDecoder::Format;
+
+static const Format formats[] = {
+	Format::S8, Format::U8, Format::S16, Format::U16, Format::S32, Format::U32, Format::F32
+};
+
+static std::vector<uint8_t> RandomSamples(std::mt19937& rng, Format format, int count) {
+	std::vector<uint8_t> samples(count * AudioDecoder::GetSamplesizeForFormat(format));
+	if (format == Format::F32) {
+		std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+		for (int i = 0; i < count; ++i) {
+			float v = dist(rng);
+			memcpy(&samples[i * sizeof(float)], &v, sizeof(v));
+		}
+	} else {
+		for (auto& s : samples) {
+			s = rng();
+		}
+	}
+	return samples;
+}
+
+// Conversion of the previous per sample mixer
+static double Reference(const uint8_t* samples, int i, Format format) {
+	switch (format) {
+		case Format::S8: return ((const int8_t*)samples)[i] / 128.0;
+		case Format::U8: return ((const uint8_t*)samples)[i] / 128.0 - 1.0;
+		case Format::S16: return ((const int16_t*)samples)[i] / 32768.0;
+		case Format::U16: return ((const uint16_t*)samples)[i] / 32768.0 - 1.0;
+		case Format::S32: return ((const int32_t*)samples)[i] / 2147483648.0;
+		case Format::U32: return ((const uint32_t*)samples)[i] / 2147483648.0 - 1.0;
+		case Format::F32: return ((const float*)samples)[i];
+	}
+	return 0.0;
+}
+
+TEST_CASE("Mix: Converts all formats") {
+	std::mt19937 rng(1234);
+
+	for (Format format : formats) {
+		for (int channels = 1; channels <= 4; ++channels) {
+			// Odd size to test the remainder
+			const int frames = 67;
+			auto samples = RandomSamples(rng, format, frames * channels);
+
+			for (Implementation impl : { Impl_Scalar, Impl_Vector128 }) {
+				if (!IsSupported(impl)) {
+					continue;
+				}
+
+				std::vector<float> mix(frames * 2, 0.25f);
+				Mix(mix.data(), samples.data(), frames, format, channels, 0.5f, false, impl);
+
+				for (int i = 0; i < frames; ++i) {
+					for (int c = 0; c < 2; ++c) {
+						double expected = 0.25 + 0.5 * Reference(samples.data(), i * channels + (channels > 1 ? c : 0), format);
+						REQUIRE(mix[i * 2 + c] == doctest::Approx(expected).epsilon(1e-5));
+					}
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("Mix: Vectorized output matches scalar") {
+	std::mt19937 rng(4321);
+
+	for (Format format : formats) {
+		for (int channels = 1; channels <= 4; ++channels) {
+			for (bool overwrite : { false, true }) {
+				const int frames = 259;
+				auto samples = RandomSamples(rng, format, frames * channels);
+
+				std::vector<float> expected(frames * 2, -0.125f);
+				auto mix = expected;
+				Mix(expected.data(), samples.data(), frames, format, channels, 0.75f, overwrite, Impl_Scalar);
+				Mix(mix.data(), samples.data(), frames, format, channels, 0.75f, overwrite, Impl_Vector128);
+
+				for (size_t i = 0; i < mix.size(); ++i) {
+					REQUIRE(mix[i] == doctest::Approx(expected[i]).epsilon(1e-6));
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("Clip: Compresses loud samples") {
+	const std::vector<float> mix = { 0.0f, 0.5f, -0.5f, 0.8f, 1.0f, -1.0f, 1.5f, -1.5f, 2.0f };
+
+	for (Implementation impl : { Impl_Scalar, Impl_Vector128 }) {
+		std::vector<int16_t> out(mix.size());
+
+		// No compression below full volume, out of range samples saturate
+		Clip(out.data(), mix.data(), mix.size(), 1.0f, impl);
+		REQUIRE(out == std::vector<int16_t>{ 0, 16384, -16384, 26214, 32767, -32768, 32767, -32768, 32767 });
+
+		// Samples up to the total volume fit into the range
+		Clip(out.data(), mix.data(), mix.size(), 2.0f, impl);
+		CHECK(out[1] == 16384);
+		CHECK(out[3] == 26214);
+		CHECK(out[6] == doctest::Approx(32768 * (0.8 + 0.2 * 0.7 / 1.2)).epsilon(1e-4));
+		CHECK(out[7] == -out[6]);
+		CHECK(out[8] == 32767);
+	}
+}
+
+TEST_CASE("Clip: Vectorized output matches scalar") {
+	std::mt19937 rng(5678);
+	std::uniform_real_distribution<float> dist(-3.0f, 3.0f);
+
+	std::vector<float> mix(1027);
+	for (auto& s : mix) {
+		s = dist(rng);
+	}
+
+	for (float total_volume : { 0.5f, 1.0f, 1.5f, 3.0f }) {
+		std::vector<int16_t> expected(mix.size());
+		std::vector<int16_t> out(mix.size());
+		Clip(expected.data(), mix.data(), mix.size(), total_volume, Impl_Scalar);
+		Clip(out.data(), mix.data(), mix.size(), total_volume, Impl_Vector128);
+
+		for (size_t i = 0; i < out.size(); ++i) {
+			REQUIRE(std::abs(out[i] - expected[i]) <= 1);
+		}
+	}
+}
@@ -0,0 +1,108 @@
+#include <random>
+#include <vector>
+#include "bitmap_kernels.h"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+using namespace BitmapKernels;
+
+static std::vector<uint32_t> RandomPixels(std::mt19937& rng, int count) {
+	std::vector<uint32_t> pixels(count);
+	for (auto& p : pixels) {
+		p = rng();
+		// Plenty of fully transparent and fully opaque pixels
+		switch (rng() % 4) {
+			case 0: p &= 0xFFFFFF00; break;
+			case 1: p |= 0xFF; break;
+		}
+	}
+	return pixels;
+}
+
+static const Implementation vector_impls[] = { Impl_Vector128, Impl_Vector256 };
+
+TEST_CASE("ToneRow: Vectorized output matches scalar") {
+	std::mt19937 rng(1234);
+
+	// RGBA and ABGR layout
+	const Shifts formats[] = { {24, 16, 8, 0}, {0, 8, 16, 24} };
+
+	for (int i = 0; i < 2000; ++i) {
+		Tone tone(rng() % 256, rng() % 256, rng() % 256, rng() % 256);
+		switch (i % 4) {
+			case 0: tone.gray = 128; break;
+			case 1: tone.red = tone.green = tone.blue = 128; break;
+		}
+		if (tone == Tone(128, 128, 128, 128)) {
+			continue;
+		}
+
+		const Shifts& shifts = formats[i % 2];
+		bool skip_transparent = (i / 2) % 2 == 0;
+
+		// Odd size to test the remainder
+		auto expected = RandomPixels(rng, 67);
+		auto input = expected;
+		ToneRow(expected.data(), expected.size(), tone, shifts, skip_transparent, Impl_Scalar);
+
+		for (Implementation impl : vector_impls) {
+			if (!IsSupported(impl)) {
+				continue;
+			}
+
+			auto pixels = input;
+			ToneRow(pixels.data(), pixels.size(), tone, shifts, skip_transparent, impl);
+			REQUIRE(pixels == expected);
+		}
+	}
+}
+
+TEST_CASE("HueChangeRow: Vectorized output matches scalar") {
+	std::mt19937 rng(4321);
+
+	for (int hue = 0; hue <= 0x600; hue += 7) {
+		auto expected = RandomPixels(rng, 259);
+		// Gray pixels and identical channels
+		expected[0] = 0x80808080;
+		expected[1] = 0xFFFF00FF;
+		expected[2] = 0x00FFFFFF;
+		expected[3] = 0x000000FF;
+		expected[4] = 0xFFFFFFFF;
+		auto input = expected;
+		HueChangeRow(expected.data(), expected.size(), hue, Impl_Scalar);
+
+		for (Implementation impl : vector_impls) {
+			if (!IsSupported(impl)) {
+				continue;
+			}
+
+			auto pixels = input;
+			HueChangeRow(pixels.data(), pixels.size(), hue, impl);
+			REQUIRE(pixels == expected);
+		}
+	}
+}
+
+TEST_CASE("HueChangeRow: All colors") {
+	for (Implementation impl : vector_impls) {
+		if (!IsSupported(impl)) {
+			continue;
+		}
+
+		std::vector<uint32_t> input(256 * 256);
+		for (int r = 0; r < 256; r += 3) {
+			for (int g = 0; g < 256; ++g) {
+				for (int b = 0; b < 256; ++b) {
+					input[g * 256 + b] = (r << 24) | (g << 16) | (b << 8) | 0xFF;
+				}
+			}
+
+			auto expected = input;
+			auto pixels = input;
+			HueChangeRow(expected.data(), expected.size(), 0x180, Impl_Scalar);
+			HueChangeRow(pixels.data(), pixels.size(), 0x180, impl);
+			REQUIRE(pixels == expected);
+		}
+	}
+}
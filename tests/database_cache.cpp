@@ -0,0 +1,131 @@
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "data.h"
+#include "database_cache.h"
+#include "filefinder.h"
+#include "ldb_reader.h"
+#include "lmt_reader.h"
+#include "main_data.h"
+#include "options.h"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+static const std::string ldb = "database_cache_test.ldb";
+static const std::string lmt = "database_cache_test.lmt";
+
+// Database and map tree as written by LcfWriter
+static std::string Dump() {
+	std::ostringstream ldb_stream;
+	std::ostringstream lmt_stream;
+	LDB_Reader::Save(ldb_stream, "", SaveOpt::ePreserveHeader);
+	LMT_Reader::Save(lmt_stream, "", SaveOpt::ePreserveHeader);
+	return ldb_stream.str() + lmt_stream.str();
+}
+
+// Writes a small project and loads it like Player::LoadDatabase
+static std::string CreateProject(int maps = 3) {
+	Data::Clear();
+	Data::data.ldb_header = "LcfDataBase";
+	Data::system.ldb_id = 2003;
+	Data::actors.resize(2);
+	Data::actors[0].ID = 1;
+	Data::actors[0].name = "Alex";
+	Data::actors[0].Setup();
+	Data::items.resize(4);
+	Data::items[2].name = "Potion";
+	Data::treemap.maps.resize(maps);
+	Data::treemap.maps[1].name = "Town";
+
+	REQUIRE(LDB_Reader::Save(ldb, "1252"));
+	REQUIRE(LMT_Reader::Save(lmt, "1252"));
+
+	Data::Clear();
+	REQUIRE(LDB_Reader::Load(ldb, "1252"));
+	REQUIRE(LMT_Reader::Load(lmt, "1252"));
+
+	Main_Data::SetSavePath(".");
+	return Dump();
+}
+
+static void RemoveProject() {
+	std::remove(ldb.c_str());
+	std::remove(lmt.c_str());
+	std::remove(DATABASE_CACHE_NAME);
+	Data::Clear();
+}
+
+TEST_SUITE_BEGIN("DatabaseCache");
+
+TEST_CASE("GetFileModificationTime") {
+	CreateProject();
+
+	CHECK(FileFinder::GetFileModificationTime(ldb) > 0);
+	CHECK(FileFinder::GetFileModificationTime("database_cache_missing.ldb") == -1);
+
+	RemoveProject();
+}
+
+TEST_CASE("SaveLoad") {
+	const std::string expected = CreateProject();
+	std::remove(DATABASE_CACHE_NAME);
+
+	CHECK(!DatabaseCache::Load(ldb, lmt, "1252"));
+	CHECK(DatabaseCache::GetEncoding(ldb, lmt).empty());
+
+	REQUIRE(DatabaseCache::Save(ldb, lmt, "1252"));
+	Data::Clear();
+
+	CHECK(DatabaseCache::GetEncoding(ldb, lmt) == "1252");
+	REQUIRE(DatabaseCache::Load(ldb, lmt, "1252"));
+	CHECK(Dump() == expected);
+	CHECK(Data::actors[0].name == "Alex");
+	CHECK(Data::treemap.maps[1].name == "Town");
+
+	RemoveProject();
+}
+
+TEST_CASE("RejectEncoding") {
+	CreateProject();
+	REQUIRE(DatabaseCache::Save(ldb, lmt, "1252"));
+
+	CHECK(!DatabaseCache::Load(ldb, lmt, "932"));
+
+	RemoveProject();
+}
+
+TEST_CASE("RejectChangedFile") {
+	CreateProject();
+	REQUIRE(DatabaseCache::Save(ldb, lmt, "1252"));
+
+	// Changes the size of the map tree
+	CreateProject(5);
+
+	CHECK(DatabaseCache::GetEncoding(ldb, lmt).empty());
+	CHECK(!DatabaseCache::Load(ldb, lmt, "1252"));
+
+	RemoveProject();
+}
+
+TEST_CASE("RejectChecksum") {
+	CreateProject();
+	REQUIRE(DatabaseCache::Save(ldb, lmt, "1252"));
+
+	{
+		std::fstream stream(DATABASE_CACHE_NAME, std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+		stream.seekg(-3, std::ios_base::end);
+		const char c = static_cast<char>(stream.get());
+		stream.seekp(-3, std::ios_base::end);
+		stream.put(static_cast<char>(c ^ 0xFF));
+	}
+
+	Data::Clear();
+	CHECK(!DatabaseCache::Load(ldb, lmt, "1252"));
+	CHECK(Data::actors.empty());
+
+	RemoveProject();
+}
+
+TEST_SUITE_END();
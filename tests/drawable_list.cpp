@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "drawable.h"
+#include "graphics.h"
+#include "scene.h"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+namespace {
+	class TestDrawable : public Drawable {
+	public:
+		TestDrawable(int z) : z(z) {
+			Graphics::RegisterDrawable(this);
+		}
+
+		~TestDrawable() override {
+			Graphics::RemoveDrawable(this);
+		}
+
+		void Draw() override {}
+
+		int GetZ() const override {
+			return z;
+		}
+
+		DrawableType GetType() const override {
+			return TypeDefault;
+		}
+
+		void SetZ(int new_z) {
+			z = new_z;
+			Graphics::UpdateZCallback(this);
+		}
+
+	private:
+		int z;
+	};
+
+	struct GraphicsFixture {
+		GraphicsFixture() {
+			Graphics::Init();
+		}
+
+		~GraphicsFixture() {
+			Graphics::Quit();
+		}
+
+		const Graphics::DrawableList& List() const {
+			return Scene::instance->GetGraphicsState().drawable_list;
+		}
+	};
+}
+
+// Order the drawables had with a stable sort by Z after every change
+static std::vector<Drawable*> StableSorted(std::vector<Drawable*> list) {
+	std::stable_sort(list.begin(), list.end(), [](const Drawable* a, const Drawable* b) {
+		return a->GetZ() < b->GetZ();
+	});
+	return list;
+}
+
+TEST_SUITE_BEGIN("DrawableList");
+
+TEST_CASE_FIXTURE(GraphicsFixture, "RegistrationOrder") {
+	TestDrawable a(10);
+	TestDrawable b(5);
+	TestDrawable c(10);
+
+	CHECK(List() == std::vector<Drawable*>{ &b, &a, &c });
+}
+
+TEST_CASE_FIXTURE(GraphicsFixture, "MoveUpAndBack") {
+	TestDrawable a(10);
+	TestDrawable b(10);
+	CHECK(List() == std::vector<Drawable*>{ &a, &b });
+
+	a.SetZ(20);
+	CHECK(List() == std::vector<Drawable*>{ &b, &a });
+
+	a.SetZ(10);
+	CHECK(List() == std::vector<Drawable*>{ &b, &a });
+}
+
+TEST_CASE_FIXTURE(GraphicsFixture, "MoveDownAndBack") {
+	TestDrawable a(10);
+	TestDrawable b(10);
+
+	b.SetZ(5);
+	CHECK(List() == std::vector<Drawable*>{ &b, &a });
+
+	b.SetZ(10);
+	CHECK(List() == std::vector<Drawable*>{ &a, &b });
+}
+
+TEST_CASE_FIXTURE(GraphicsFixture, "MatchesStableSort") {
+	std::vector<std::unique_ptr<TestDrawable>> drawables;
+	for (int i = 0; i < 8; ++i) {
+		drawables.emplace_back(new TestDrawable(i % 3));
+	}
+
+	std::vector<Drawable*> expected = List();
+	for (int i = 0; i < 200; ++i) {
+		TestDrawable& drawable = *drawables[(i * 5) % drawables.size()];
+		drawable.SetZ((i * 7) % 4);
+		expected = StableSorted(expected);
+		CHECK(List() == expected);
+	}
+}
+
+TEST_SUITE_END();
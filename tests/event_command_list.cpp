@@ -0,0 +1,130 @@
+#include <random>
+#include <vector>
+#include "event_command_list.h"
+#include "command_codes.h"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+// Linear searches of the interpreter before the index was added
+
+static int LinearFind(const std::vector<RPG::EventCommand>& list, int start, int code, int code2, int min_indent, int max_indent) {
+	int idx;
+	for (idx = start; (size_t) idx < list.size(); idx++) {
+		if (list[idx].indent < min_indent)
+			return EventCommandList::jump_blocked;
+		if (list[idx].indent > max_indent)
+			continue;
+		if (list[idx].code != code &&
+			list[idx].code != code2)
+			continue;
+		return idx;
+	}
+	return idx;
+}
+
+static int LinearEndLoop(const std::vector<RPG::EventCommand>& list, int start) {
+	int indent = list[start].indent;
+	for (int idx = start; idx >= 0; idx--) {
+		if (list[idx].indent > indent)
+			continue;
+		if (list[idx].indent < indent)
+			return EventCommandList::jump_blocked;
+		if (list[idx].code != Cmd::Loop)
+			continue;
+		return idx;
+	}
+	return EventCommandList::jump_none;
+}
+
+static int LinearLabel(const std::vector<RPG::EventCommand>& list, int label_id) {
+	for (int idx = 0; (size_t)idx < list.size(); idx++) {
+		if (list[idx].code != Cmd::Label)
+			continue;
+		if (list[idx].parameters[0] != label_id)
+			continue;
+		return idx;
+	}
+	return EventCommandList::jump_none;
+}
+
+static std::vector<RPG::EventCommand> RandomList(std::mt19937& rng, int size) {
+	static const int codes[] = {
+		Cmd::ConditionalBranch, Cmd::ElseBranch, Cmd::EndBranch,
+		Cmd::Loop, Cmd::BreakLoop, Cmd::EndLoop, Cmd::Label,
+		Cmd::ShowChoiceOption, Cmd::ShowChoiceEnd, Cmd::Wait
+	};
+
+	std::vector<RPG::EventCommand> list(size);
+	int indent = 0;
+	for (auto& com : list) {
+		// Random walk, nested blocks with occasional jumps in the indent
+		indent = std::max(0, indent + static_cast<int>(rng() % 5) - 2);
+		com.indent = indent;
+		com.code = codes[rng() % (sizeof(codes) / sizeof(codes[0]))];
+		com.parameters.push_back(rng() % 8);
+	}
+	return list;
+}
+
+TEST_CASE("Find: Matches linear search") {
+	std::mt19937 rng(42);
+
+	for (int i = 0; i < 300; ++i) {
+		auto commands = RandomList(rng, 1 + rng() % 80);
+		EventCommandList list(commands);
+
+		for (size_t start = 0; start < commands.size(); ++start) {
+			int indent = commands[start].indent;
+			const int ranges[][2] = { { indent, indent }, { 0, indent - 1 }, { 0, indent }, { indent - 1, indent + 1 } };
+			for (auto& range : ranges) {
+				REQUIRE(list.Find(start, Cmd::ElseBranch, Cmd::EndBranch, range[0], range[1]) ==
+					LinearFind(commands, start, Cmd::ElseBranch, Cmd::EndBranch, range[0], range[1]));
+			}
+		}
+	}
+}
+
+TEST_CASE("Loop and label jumps: Match linear search") {
+	std::mt19937 rng(7);
+
+	for (int i = 0; i < 300; ++i) {
+		auto commands = RandomList(rng, 1 + rng() % 80);
+		EventCommandList list(commands);
+
+		for (size_t idx = 0; idx < commands.size(); ++idx) {
+			const auto& com = commands[idx];
+			if (com.code == Cmd::EndLoop) {
+				REQUIRE(list.GetEndLoopTarget(idx) == LinearEndLoop(commands, idx));
+			} else if (com.code == Cmd::BreakLoop) {
+				int max_indent = com.indent - 1 < 0 ? com.indent : com.indent - 1;
+				REQUIRE(list.GetBreakLoopTarget(idx) == LinearFind(commands, idx, Cmd::EndLoop, Cmd::EndLoop, 0, max_indent));
+			}
+		}
+
+		for (int label = 0; label < 8; ++label) {
+			REQUIRE(list.GetLabel(label) == LinearLabel(commands, label));
+		}
+	}
+}
+
+TEST_CASE("MoveEvent: Route is decoded on creation") {
+	RPG::EventCommand com;
+	com.code = Cmd::MoveEvent;
+	// Event, frequency, repeat, skippable, then the encoded move commands
+	com.parameters = { 10005, 3, 1, 0, 1, 32, 0x81, 0x00, 33, 7, 12 };
+
+	EventCommandList list({ com });
+	const RPG::MoveRoute& route = list.GetMoveRoute(0);
+
+	CHECK(route.repeat);
+	CHECK(!route.skippable);
+	REQUIRE(route.move_commands.size() == 4);
+	CHECK(route.move_commands[0].command_id == 1);
+	CHECK(route.move_commands[1].command_id == 32);
+	CHECK(route.move_commands[1].parameter_a == 128);
+	CHECK(route.move_commands[2].command_id == 33);
+	CHECK(route.move_commands[2].parameter_a == 7);
+	CHECK(route.move_commands[3].command_id == 12);
+	CHECK(route == EventCommandList::DecodeMoveRoute(com));
+}
@@ -0,0 +1,104 @@
+#include <string>
+#include <vector>
+#include "game_pathfinder.h"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+// Map rows, '#' is a wall
+static Game_Pathfinder::Grid MakeGrid(const std::vector<std::string>& rows, bool loop = false) {
+	Game_Pathfinder::Grid grid;
+	grid.width = rows[0].size();
+	grid.height = rows.size();
+	grid.loop_horizontal = loop;
+	grid.loop_vertical = loop;
+	grid.can_step = [rows, loop](int x, int y, int dir, bool) {
+		static const int dx[] = { 0, 1, 0, -1 };
+		static const int dy[] = { -1, 0, 1, 0 };
+		const int w = rows[0].size();
+		const int h = rows.size();
+		const int nx = (x + dx[dir] + w) % w;
+		const int ny = (y + dy[dir] + h) % h;
+		return rows[ny][nx] != '#';
+	};
+	return grid;
+}
+
+// Follows a path and returns the reached tile
+static std::pair<int, int> Walk(const Game_Pathfinder::Grid& grid, int x, int y, const std::vector<int>& path) {
+	static const int dx[] = { 0, 1, 0, -1 };
+	static const int dy[] = { -1, 0, 1, 0 };
+	for (int dir : path) {
+		REQUIRE(grid.can_step(x, y, dir, false));
+		x = (x + dx[dir] + grid.width) % grid.width;
+		y = (y + dy[dir] + grid.height) % grid.height;
+	}
+	return { x, y };
+}
+
+TEST_SUITE_BEGIN("Game_Pathfinder");
+
+TEST_CASE("StraightLine") {
+	auto grid = MakeGrid({
+		".....",
+	});
+
+	auto result = Game_Pathfinder::Search(grid, 0, 0, 4, 0);
+	CHECK(result.reached);
+	CHECK(result.path == std::vector<int>{ 1, 1, 1, 1 });
+}
+
+TEST_CASE("AroundWall") {
+	auto grid = MakeGrid({
+		"..#..",
+		"..#..",
+		"..#..",
+		".....",
+	});
+
+	auto result = Game_Pathfinder::Search(grid, 0, 0, 4, 0);
+	CHECK(result.reached);
+	CHECK(result.path.size() == 10);
+	CHECK(Walk(grid, 0, 0, result.path) == std::make_pair(4, 0));
+}
+
+TEST_CASE("Unreachable") {
+	auto grid = MakeGrid({
+		"...#.",
+		"...#.",
+		"####.",
+	});
+
+	auto result = Game_Pathfinder::Search(grid, 0, 0, 4, 0);
+	CHECK(!result.reached);
+	// Walks to the closest reachable tile
+	CHECK(Walk(grid, 0, 0, result.path) == std::make_pair(2, 0));
+}
+
+TEST_CASE("Looping") {
+	auto grid = MakeGrid({
+		"..#...",
+		"..#...",
+		"..#...",
+	}, true);
+
+	auto result = Game_Pathfinder::Search(grid, 1, 1, 4, 1);
+	CHECK(result.reached);
+	// Wraps around the left edge instead of being blocked by the wall
+	CHECK(result.path == std::vector<int>{ 3, 3, 3 });
+}
+
+TEST_CASE("NodeLimit") {
+	auto grid = MakeGrid({
+		"..........",
+		"..........",
+		"..........",
+	});
+
+	auto result = Game_Pathfinder::Search(grid, 0, 0, 9, 2, 3);
+	CHECK(!result.reached);
+	CHECK(result.nodes == 3);
+	CHECK(!result.path.empty());
+}
+
+TEST_SUITE_END();